@@ -1,31 +1,15 @@
-QT       += core gui
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    main.cpp \
-    mainwindow.cpp \
-    entity.cpp \
-    entitymanager.cpp
-
-HEADERS += \
-    mainwindow.h \
-    entity.h \
-    entitymanager.h
-
-FORMS += \
-    mainwindow.ui
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    resources.qrc
+TEMPLATE = subdirs
+
+# core: biblioteca estática da cena, sem QtWidgets
+# app: o editor, uma view sobre o core
+# tools: ferramentas de linha de comando sobre o mesmo core
+# benchmarks: QtTest/QBENCHMARK dos caminhos quentes, com saída em JSON
+SUBDIRS = \
+    core \
+    app \
+    tools \
+    benchmarks
+
+app.depends = core
+tools.depends = core
+benchmarks.depends = core
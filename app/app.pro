@@ -0,0 +1,45 @@
+QT       += core gui concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17
+
+TARGET = Project2
+
+include(../core/core.pri)
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    diagnosticsdock.cpp \
+    inputlatencyprobe.cpp \
+    main.cpp \
+    mainwindow.cpp \
+    memorydock.cpp \
+    performancehud.cpp \
+    sceneview.cpp \
+    tilelayeritem.cpp \
+    tilepixmapcache.cpp
+
+HEADERS += \
+    diagnosticsdock.h \
+    inputlatencyprobe.h \
+    mainwindow.h \
+    memorydock.h \
+    performancehud.h \
+    sceneview.h \
+    tilelayeritem.h \
+    tilepixmapcache.h
+
+FORMS += \
+    mainwindow.ui
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+RESOURCES += \
+    resources.qrc
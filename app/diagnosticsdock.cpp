@@ -0,0 +1,88 @@
+#include "diagnosticsdock.h"
+#include "latencyhistogram.h"
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+enum Column {
+    CommandColumn,
+    CountColumn,
+    P50Column,
+    P90Column,
+    P99Column,
+    MaxColumn,
+    ColumnCount
+};
+
+QTableWidgetItem *numberItem(const QString &text)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString milliseconds(qint64 nsecs)
+{
+    return QString::number(nsecs / 1e6, 'f', 2);
+}
+
+}
+
+DiagnosticsDock::DiagnosticsDock(QWidget *parent)
+    : QDockWidget("Diagnóstico", parent),
+      m_latencyTable(new QTableWidget(0, ColumnCount)),
+      m_refreshTimer(new QTimer(this))
+{
+    setObjectName("diagnosticsDock");
+    setAllowedAreas(Qt::AllDockWidgetAreas);
+
+    m_latencyTable->setHorizontalHeaderLabels({ "Comando", "N", "p50 (ms)", "p90 (ms)", "p99 (ms)", "Máx (ms)" });
+    m_latencyTable->horizontalHeader()->setSectionResizeMode(CommandColumn, QHeaderView::Stretch);
+    m_latencyTable->verticalHeader()->hide();
+    m_latencyTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_latencyTable->setSelectionMode(QAbstractItemView::NoSelection);
+
+    QPushButton *resetButton = new QPushButton("Zerar");
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        CommandLatencies::instance().reset();
+        refresh();
+    });
+
+    QWidget *container = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(container);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->addWidget(m_latencyTable);
+    layout->addWidget(resetButton, 0, Qt::AlignRight);
+    setWidget(container);
+
+    m_refreshTimer->setInterval(RefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &DiagnosticsDock::refresh);
+    connect(this, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            refresh();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    });
+}
+
+void DiagnosticsDock::refresh()
+{
+    CommandLatencies &latencies = CommandLatencies::instance();
+    const QStringList commands = latencies.commands();
+    m_latencyTable->setRowCount(commands.size());
+    for (int row = 0; row < commands.size(); ++row) {
+        const LatencyHistogram &histogram = latencies.histogram(commands.at(row));
+        m_latencyTable->setItem(row, CommandColumn, new QTableWidgetItem(commands.at(row)));
+        m_latencyTable->setItem(row, CountColumn, numberItem(QString::number(histogram.count())));
+        m_latencyTable->setItem(row, P50Column, numberItem(milliseconds(histogram.percentileNsecs(50))));
+        m_latencyTable->setItem(row, P90Column, numberItem(milliseconds(histogram.percentileNsecs(90))));
+        m_latencyTable->setItem(row, P99Column, numberItem(milliseconds(histogram.percentileNsecs(99))));
+        m_latencyTable->setItem(row, MaxColumn, numberItem(milliseconds(histogram.maxNsecs())));
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef DIAGNOSTICSDOCK_H
+#define DIAGNOSTICSDOCK_H
+
+#include <QDockWidget>
+
+class QTableWidget;
+class QTimer;
+
+// Dock com as latências por comando do editor (CommandLatencies).
+//
+// A tabela só é atualizada, a cada RefreshIntervalMs, enquanto o dock está visível.
+class DiagnosticsDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RefreshIntervalMs = 1000;
+
+    explicit DiagnosticsDock(QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+private:
+    QTableWidget *m_latencyTable;
+    QTimer *m_refreshTimer;
+};
+
+#endif // DIAGNOSTICSDOCK_H
@@ -0,0 +1,128 @@
+#include "inputlatencyprobe.h"
+#include "latencyhistogram.h"
+#include <QGraphicsItem>
+#include <QGraphicsView>
+#include <QRegion>
+#include <QStringList>
+
+InputLatencyProbe::InputLatencyProbe()
+    : m_enabled(false),
+      m_target(nullptr),
+      m_histogram(&CommandLatencies::instance().histogram("inputToPixel")),
+      m_pendingSinceNsecs(-1),
+      m_pendingMoves(0),
+      m_appliedSinceNsecs(-1),
+      m_appliedMoves(0),
+      m_inputCount(0),
+      m_measuredCount(0),
+      m_coalescedCount(0),
+      m_droppedCount(0)
+{
+    m_clock.start();
+}
+
+void InputLatencyProbe::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    if (enabled) {
+        reset();
+    }
+}
+
+void InputLatencyProbe::inputReceived()
+{
+    if (!m_enabled) {
+        return;
+    }
+    ++m_inputCount;
+    if (m_pendingMoves == 0) {
+        m_pendingSinceNsecs = m_clock.nsecsElapsed();
+    }
+    ++m_pendingMoves;
+}
+
+void InputLatencyProbe::moveApplied()
+{
+    if (!m_enabled || m_pendingMoves == 0) {
+        return;
+    }
+    // Um setPos ainda não desenhado é substituído por este: seus movimentos ficam agrupados
+    if (m_appliedMoves == 0) {
+        m_appliedSinceNsecs = m_pendingSinceNsecs;
+    }
+    m_appliedMoves += m_pendingMoves;
+    m_pendingMoves = 0;
+    m_pendingSinceNsecs = -1;
+}
+
+void InputLatencyProbe::dropPending()
+{
+    if (!m_enabled) {
+        return;
+    }
+    m_droppedCount += m_pendingMoves;
+    m_pendingMoves = 0;
+    m_pendingSinceNsecs = -1;
+}
+
+void InputLatencyProbe::discard()
+{
+    if (!m_enabled) {
+        return;
+    }
+    dropPending();
+    m_droppedCount += m_appliedMoves;
+    m_appliedMoves = 0;
+    m_appliedSinceNsecs = -1;
+}
+
+void InputLatencyProbe::framePainted(const QGraphicsView *view, const QRegion &exposed)
+{
+    if (!m_enabled || m_appliedMoves == 0 || !m_target) {
+        return;
+    }
+    if (!m_target->isVisible()) {
+        discard();
+        return;
+    }
+    // Paints que não tocam o preview (HUD, tiles longe do cursor) não mostram o movimento
+    const QRect previewRect = view->mapFromScene(m_target->sceneBoundingRect()).boundingRect();
+    if (!exposed.intersects(previewRect)) {
+        return;
+    }
+
+    m_histogram->record(m_clock.nsecsElapsed() - m_appliedSinceNsecs);
+    ++m_measuredCount;
+    m_coalescedCount += m_appliedMoves - 1;
+    m_appliedMoves = 0;
+    m_appliedSinceNsecs = -1;
+}
+
+void InputLatencyProbe::reset()
+{
+    m_histogram->reset();
+    m_pendingSinceNsecs = -1;
+    m_pendingMoves = 0;
+    m_appliedSinceNsecs = -1;
+    m_appliedMoves = 0;
+    m_inputCount = 0;
+    m_measuredCount = 0;
+    m_coalescedCount = 0;
+    m_droppedCount = 0;
+}
+
+QString InputLatencyProbe::report() const
+{
+    QStringList result;
+    result << QString("Entrada até pixel: p50 %1 ms  p90 %2 ms  p99 %3 ms  máximo %4 ms")
+                  .arg(m_histogram->percentileNsecs(50) / 1e6, 0, 'f', 2)
+                  .arg(m_histogram->percentileNsecs(90) / 1e6, 0, 'f', 2)
+                  .arg(m_histogram->percentileNsecs(99) / 1e6, 0, 'f', 2)
+                  .arg(m_histogram->maxNsecs() / 1e6, 0, 'f', 2);
+    result << QString("Movimentos: %1 recebidos, %2 medidos, %3 agrupados, %4 descartados")
+                  .arg(m_inputCount).arg(m_measuredCount).arg(m_coalescedCount).arg(m_droppedCount);
+    return result.join('\n');
+}
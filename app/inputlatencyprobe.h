@@ -0,0 +1,72 @@
+#ifndef INPUTLATENCYPROBE_H
+#define INPUTLATENCYPROBE_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+class LatencyHistogram;
+class QGraphicsItem;
+class QGraphicsView;
+class QRegion;
+
+// Latência de entrada até pixel do preview do pincel.
+//
+// Cada MouseMove da viewport é carimbado ao chegar no eventFilter; o setPos do preview
+// (applyPendingPreviewPosition) passa o movimento para "aplicado" e o primeiro paint da
+// viewport cuja região exposta cobre o preview fecha a medida. A medida sai do movimento
+// mais antigo ainda não desenhado, que é o atraso que o usuário vê; os outros movimentos
+// desse quadro contam como agrupados, e os que nunca chegam a um paint (posição igual,
+// preview escondido) como descartados. O fim do paintEvent é o mais perto da tela que
+// dá para medir daqui: a composição do sistema fica de fora.
+//
+// Desligado, cada chamada é um teste de bool.
+class InputLatencyProbe
+{
+public:
+    InputLatencyProbe();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+    void setTarget(const QGraphicsItem *item) { m_target = item; }
+
+    // MouseMove chegou na viewport
+    void inputReceived();
+    // O preview foi para a posição dos movimentos pendentes
+    void moveApplied();
+    // Os movimentos pendentes não vão mudar nenhum pixel
+    void dropPending();
+    // O preview sumiu: nada pendente ou aplicado vai ser desenhado
+    void discard();
+    // Fim de um paint da viewport, com a região que foi repintada
+    void framePainted(const QGraphicsView *view, const QRegion &exposed);
+
+    const LatencyHistogram &histogram() const { return *m_histogram; }
+    quint64 inputCount() const { return m_inputCount; }
+    quint64 measuredCount() const { return m_measuredCount; }
+    quint64 coalescedCount() const { return m_coalescedCount; }
+    quint64 droppedCount() const { return m_droppedCount; }
+
+    void reset();
+    // Texto de várias linhas para o log
+    QString report() const;
+
+private:
+    bool m_enabled;
+    const QGraphicsItem *m_target;
+    LatencyHistogram *m_histogram;
+    QElapsedTimer m_clock;
+
+    // Movimentos ainda não aplicados ao preview, e aplicados mas ainda não desenhados;
+    // o carimbo é o do mais antigo de cada grupo, -1 sem nenhum
+    qint64 m_pendingSinceNsecs;
+    int m_pendingMoves;
+    qint64 m_appliedSinceNsecs;
+    int m_appliedMoves;
+
+    quint64 m_inputCount;
+    quint64 m_measuredCount;
+    quint64 m_coalescedCount;
+    quint64 m_droppedCount;
+};
+
+#endif // INPUTLATENCYPROBE_H
@@ -0,0 +1,43 @@
+#include <QApplication>
+#include <QMessageBox>
+#include <QDebug>
+#include "asynclogger.h"
+#include "latencyhistogram.h"
+#include "stallwatchdog.h"
+#include "mainwindow.h"
+
+int main(int argc, char *argv[])
+{
+    try {
+        QApplication a(argc, argv);
+
+        // Todo o log (SCENE_LOG_* e qDebug/qCInfo) sai da thread da interface e vai em lotes
+        // para o app_log.txt; avisos e erros continuam também no console
+        AsyncLogger::installMessageHandler();
+        AsyncLogger::instance().start("app_log.txt");
+
+        int result;
+        {
+            MainWindow w;
+            w.show();
+            // Vigia só o laço de eventos: a carga inicial no construtor fica de fora
+            StallWatchdog::instance().start();
+            result = a.exec();
+            StallWatchdog::instance().stop();
+        }
+        // Latências por comando da sessão, para comparar entre revisões
+        CommandLatencies::instance().writeJson("command_latency.json");
+        // Travadas da interface por operação, para decidir o que tirar da thread da interface
+        StallWatchdog::instance().writeJson("stall_report.json");
+        AsyncLogger::instance().stop();
+        return result;
+    } catch (const std::exception& e) {
+        qCritical() << "Exceção não tratada:" << e.what();
+        QMessageBox::critical(nullptr, "Erro Fatal", QString("Uma exceção não tratada ocorreu: %1").arg(e.what()));
+        return 1;
+    } catch (...) {
+        qCritical() << "Exceção desconhecida não tratada";
+        QMessageBox::critical(nullptr, "Erro Fatal", "Uma exceção desconhecida não tratada ocorreu.");
+        return 1;
+    }
+}
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "mainwindow.h"
 #include "entity.h"
 #include "entitymanager.h"
+#include "tilelayeritem.h"
+#include "sceneview.h"
+#include "diagnosticsdock.h"
+#include "memorydock.h"
 #include <QMenuBar>
 #include <QToolBar>
 #include <QStatusBar>
@@ -24,8 +28,21 @@
 #include <QAction>
 #include <QEnterEvent>
 #include <QMap>
+#include <QInputDialog>
+#include <QElapsedTimer>
+#include <QScreen>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QFileInfo>
+#include <algorithm>
+#include "asynclogger.h"
+#include "binaryscenefile.h"
+#include "latencyhistogram.h"
+#include "tracerecorder.h"
 
 Q_LOGGING_CATEGORY(mainWindowCategory, "MainWindow")
+// Caminhos quentes (pincel, borracha, preview) logam pelo AsyncLogger, filtrado por nível
+static const char mainWindowLog[] = "MainWindow";
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
@@ -33,6 +50,10 @@ MainWindow::MainWindow(QWidget *parent)
       m_scene(nullptr),
       m_sceneView(nullptr),
       m_entityManager(nullptr),
+      m_tileCache(nullptr),
+      m_currentSelectedPlacement(PlacementStore::InvalidHandle),
+      m_sceneModel(nullptr),
+      m_tileLayer(nullptr),
       m_projectExplorer(nullptr),
       m_fileSystemModel(nullptr),
       m_entityList(nullptr),
@@ -43,19 +64,31 @@ MainWindow::MainWindow(QWidget *parent)
       m_selectedEntity(nullptr),
       m_selectedTileIndex(-1),
       m_previewItem(nullptr),
+      m_previewPixmapEntity(nullptr),
+      m_previewPixmapTileIndex(-1),
+      m_previewPixmapErase(false),
+      m_previewPositionTimer(nullptr),
       m_shiftPressed(false),
       m_gridSize(0),
       m_currentTool(SelectTool),
       m_previewUpdateTimer(nullptr),
       m_ctrlPressed(false),
-      m_movingItem(nullptr),
+      m_journalTimer(nullptr),
+      m_undoStatusLabel(nullptr),
+      m_brushStrokeOpen(false),
       m_entityPreview(nullptr),
-      m_oldPosition(),
+      m_diagnosticsDock(nullptr),
+      m_memoryDock(nullptr),
       updateCount(0),
       m_lastCursorPosition(0, 0)
 {
     try {
         m_entityManager = new EntityManager();
+        m_sceneModel = new SceneModel(m_entityManager, this);
+        connect(m_sceneModel, &SceneModel::placementsChanged, this, &MainWindow::onPlacementsChanged);
+        connect(m_sceneModel, &SceneModel::placementRemoved, this, &MainWindow::onPlacementRemoved);
+        connect(m_sceneModel, &SceneModel::historyChanged, this, &MainWindow::updateUndoStatus);
+        m_tileCache = new TilePixmapCache(this);
         setupUI();
         setupSceneView();
         createActions();
@@ -70,6 +103,13 @@ MainWindow::MainWindow(QWidget *parent)
         
         qApp->installEventFilter(this);
 
+        // O journal é gravado em lote; o fsync sai daqui, não de cada edição
+        m_journalTimer = new QTimer(this);
+        m_journalTimer->setInterval(EditJournal::DefaultFlushIntervalMs);
+        connect(m_journalTimer, &QTimer::timeout, this, [this]() { m_sceneModel->journal().flush(); });
+        m_journalTimer->start();
+        QTimer::singleShot(0, this, &MainWindow::recoverFromJournal);
+
         qCInfo(mainWindowCategory) << "MainWindow inicializado com sucesso";
     } catch (const std::exception& e) {
         handleException("Erro durante a inicialização", e);
@@ -78,6 +118,9 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // Fechamento limpo: as edições não salvas não são oferecidas na próxima abertura
+    m_sceneModel->journal().stop(true);
+
     clearPreview();
     
     if (m_previewUpdateTimer) {
@@ -88,10 +131,12 @@ MainWindow::~MainWindow()
     // Limpar todos os itens da cena
     if (m_scene) {
         m_scene->clear();
+        m_tileLayer = nullptr;
+        m_previewItem = nullptr;
     }
 
-    // Limpar o mapa de entidades
-    m_entityPlacements.clear();
+    // O modelo não avisa mais a view, que já foi destruída
+    m_sceneModel->disconnect(this);
 
     // Deletar o gerenciador de entidades
     delete m_entityManager;
@@ -101,47 +146,27 @@ MainWindow::~MainWindow()
 
 void MainWindow::eraseEntity()
 {
-    if (!m_previewItem) return;
+    if (!m_previewItem || !m_previewItem->isVisible()) return;
 
+    COMMAND_LATENCY("eraseEntity");
+    TraceSpan span("MainWindow::eraseEntity", "edit");
+    // A borracha apaga sob a posição atual do cursor, não sob a do último quadro
+    applyPendingPreviewPosition();
     QRectF eraseRect = m_previewItem->sceneBoundingRect();
-    QList<QGraphicsItem*> itemsInRect = m_scene->items(eraseRect, Qt::IntersectsItemShape);
-    
-    QGraphicsItem* itemToErase = nullptr;
     qreal maxOverlapRatio = 0;
-    qreal eraseThreshold = 0.25; // 25% da borracha deve sobrepor para apagar
-
-    qreal eraseArea = eraseRect.width() * eraseRect.height();
+    const int handleToErase = m_sceneModel->eraseTarget(eraseRect, &maxOverlapRatio);
 
-    for (QGraphicsItem* item : itemsInRect) {
-        if (m_entityPlacements.contains(item) && item != m_previewItem) {
-            QRectF intersection = eraseRect.intersected(item->sceneBoundingRect());
-            qreal overlap = intersection.width() * intersection.height();
-            qreal overlapRatio = overlap / eraseArea;
+    if (handleToErase != PlacementStore::InvalidHandle) {
+        const EntityPlacement &placement = m_sceneModel->placements().at(handleToErase);
+        const QString entityName = placement.entity->getName();
+        const QPointF oldPos = placement.pos();
 
-            if (overlapRatio > eraseThreshold && overlapRatio > maxOverlapRatio) {
-                maxOverlapRatio = overlapRatio;
-                itemToErase = item;
-            }
-        }
-    }
-
-    if (itemToErase) {
-        Action action;
-        action.type = Action::REMOVE;
-        action.entity = m_entityPlacements[itemToErase].entity;
-        action.tileIndex = m_entityPlacements[itemToErase].tileIndex;
-        action.oldPos = itemToErase->pos();
-        action.entityName = action.entity->getName();
-        addAction(action);
-
-        m_scene->removeItem(itemToErase);
-        m_entityPlacements.remove(itemToErase);
-        delete itemToErase;
-        qCInfo(mainWindowCategory) << "Entidade removida e ação adicionada à pilha de undo:" 
-                                   << action.entityName << "na posição:" << action.oldPos
-                                   << "Sobreposição:" << (maxOverlapRatio * 100) << "%";
+        m_sceneModel->removePlacement(handleToErase);
+        SCENE_LOG_INFO(mainWindowLog) << "Entidade removida e ação adicionada à pilha de undo:"
+                                      << entityName << "na posição:" << oldPos
+                                      << "Sobreposição:" << (maxOverlapRatio * 100) << "%";
     } else {
-        qCInfo(mainWindowCategory) << "Nenhuma entidade para apagar na posição do preview:" << eraseRect;
+        SCENE_LOG_DEBUG(mainWindowLog) << "Nenhuma entidade para apagar na posição do preview:" << eraseRect;
     }
 }
 
@@ -157,17 +182,16 @@ QPixmap MainWindow::createErasePreviewPixmap()
     return pixmap;
 }
 
-void MainWindow::logToFile(const QString& message)
+QPixmap MainWindow::createInvisiblePreviewPixmap(const QSizeF &size)
 {
-    static QFile logFile("app_log.txt");
-    if (!logFile.isOpen()) {
-        logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
-    }
-    
-    QTextStream out(&logFile);
-    out << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz ")
-        << message << "\n";
-    out.flush();
+    // Entidades só de colisão aparecem no preview como o contorno tracejado da colisão
+    QPixmap pixmap(size.toSize());
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    painter.setPen(QPen(Qt::red, 2, Qt::DashLine));
+    painter.setBrush(Qt::transparent);
+    painter.drawRect(QRectF(1, 1, pixmap.width() - 2, pixmap.height() - 2));
+    return pixmap;
 }
 
 void MainWindow::setupUI()
@@ -227,48 +251,36 @@ void MainWindow::setupUI()
     connect(m_posYSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             this, &MainWindow::updateSelectedEntityPosition);
 
+    // Latências por comando; escondido até ser aberto pelo menu Debug
+    m_diagnosticsDock = new DiagnosticsDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_diagnosticsDock);
+    m_diagnosticsDock->hide();
+
+    // Memória por consumidor, idem; as fontes são ligadas no setupSceneView
+    m_memoryDock = new MemoryDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_memoryDock);
+    tabifyDockWidget(m_diagnosticsDock, m_memoryDock);
+    m_memoryDock->hide();
+
     // Configurar a barra de status
     this->statusBar()->showMessage("Pronto");
+    m_undoStatusLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(m_undoStatusLabel);
+    updateUndoStatus();
 }
 
 void MainWindow::updateSelectedEntityPosition()
 {
-    if (m_currentTool == SelectTool && m_currentSelectedItem) {
+    if (m_currentTool == SelectTool && m_sceneModel->placements().isValid(m_currentSelectedPlacement)) {
         QPointF newPos(m_posXSpinBox->value(), m_posYSpinBox->value());
-        QPointF oldPos = m_currentSelectedItem->pos();
-        m_currentSelectedItem->setPos(newPos);
-        m_scene->update();
-        
-        Entity* entity = getEntityForGraphicsItem(m_currentSelectedItem);
-        if (entity) {
-            Action action;
-            action.type = Action::MOVE;
-            action.entity = entity;
-            action.oldPos = oldPos;
-            action.newPos = newPos;
-            addAction(action);
-            qCInfo(mainWindowCategory) << "Entidade movida:" << entity->getName() 
-                                       << "de" << oldPos << "para" << newPos;
-        } else {
-            qCWarning(mainWindowCategory) << "Não foi possível encontrar a entidade para o item selecionado";
-        }
+        const EntityPlacement &placement = m_sceneModel->placements().at(m_currentSelectedPlacement);
+        QPointF oldPos = placement.pos();
+        m_sceneModel->movePlacement(m_currentSelectedPlacement, newPos);
+        qCInfo(mainWindowCategory) << "Entidade movida:" << placement.entity->getName()
+                                   << "de" << oldPos << "para" << placement.pos();
     }
 }
 
-Entity* MainWindow::getEntityForGraphicsItem(QGraphicsItem* item)
-{
-    QGraphicsPixmapItem* pixmapItem = dynamic_cast<QGraphicsPixmapItem*>(item);
-    if (pixmapItem) {
-        auto it = m_entityPlacements.find(pixmapItem);
-        if (it != m_entityPlacements.end()) {
-            qCInfo(mainWindowCategory) << "Entidade encontrada para o item na posição:" << pixmapItem->pos();
-            return it.value().entity;
-        }
-    }
-    qCWarning(mainWindowCategory) << "Nenhuma entidade encontrada para o item na posição:" << item->pos();
-    return nullptr;
-}
-
 void MainWindow::setupProjectExplorer()
 {
     m_fileSystemModel = new QFileSystemModel(this);
@@ -293,7 +305,7 @@ void MainWindow::setupProjectExplorer()
 void MainWindow::setupSceneView()
 {
     m_scene = new QGraphicsScene(this);
-    m_sceneView = new QGraphicsView(m_scene);
+    m_sceneView = new SceneView(m_scene);
     m_sceneView->setRenderHint(QPainter::Antialiasing);
     m_sceneView->setDragMode(QGraphicsView::ScrollHandDrag);
 
@@ -303,6 +315,29 @@ void MainWindow::setupSceneView()
     // Instalar um event filter no viewport para detectar mudanças de geometria
     m_sceneView->viewport()->installEventFilter(this);
 
+    // Todas as colocações são desenhadas por um único item
+    m_tileLayer = new TileLayerItem(&m_sceneModel->placements(), m_tileCache);
+    m_scene->addItem(m_tileLayer);
+    m_sceneView->hud().setSources(&m_sceneModel->placements(), m_tileCache, &m_entityManager->spritesheetCache());
+    m_memoryDock->setSources(m_sceneModel, m_scene, m_tileCache, &m_entityManager->spritesheetCache());
+
+    // O preview do pincel é um item só, escondido enquanto não há o que mostrar
+    m_previewItem = m_scene->addPixmap(QPixmap());
+    m_previewItem->setZValue(1000);
+    m_previewItem->hide();
+    m_sceneView->inputProbe().setTarget(m_previewItem);
+
+    // Um setPos por quadro da tela, por mais eventos de mouse que cheguem nesse intervalo
+    m_previewPositionTimer = new QTimer(this);
+    m_previewPositionTimer->setSingleShot(true);
+    m_previewPositionTimer->setTimerType(Qt::PreciseTimer);
+    const qreal refreshRate = m_sceneView->screen() ? m_sceneView->screen()->refreshRate() : 60.0;
+    m_previewPositionTimer->setInterval(qMax(1, qRound(1000.0 / (refreshRate > 0 ? refreshRate : 60.0))));
+    connect(m_previewPositionTimer, &QTimer::timeout, this, &MainWindow::applyPendingPreviewPosition);
+    connect(m_tileLayer, &TileLayerItem::placementsMoved, this, &MainWindow::onPlacementsMoved);
+    connect(m_tileLayer, &TileLayerItem::placementSelectionChanged, this, &MainWindow::onPlacementSelectionChanged);
+    connect(m_sceneView, &QGraphicsView::rubberBandChanged, this, &MainWindow::onRubberBandChanged);
+
     // Desenhar a grade inicial
     updateGrid();
 
@@ -311,45 +346,10 @@ void MainWindow::setupSceneView()
 
 void MainWindow::updateGrid()
 {
-    // Limpar linhas de grade existentes
-    for (QGraphicsItem* item : m_gridLines) {
-        m_scene->removeItem(item);
-        delete item;
-    }
-    m_gridLines.clear();
-
-    // Mostrar a grade apenas quando o Shift estiver pressionado
-    if (m_shiftPressed && m_selectedEntity) {
-        // Obter o tamanho da entidade selecionada
-        QSizeF entitySize = m_selectedEntity->getCurrentSize();
-        if (entitySize.isEmpty()) {
-            entitySize = m_selectedEntity->getCollisionSize();
-            if (entitySize.isEmpty()) {
-                entitySize = QSizeF(32, 32);
-            }
-        }
-
-        // Obter o tamanho visível da view
-        QRectF visibleRect = m_sceneView->mapToScene(m_sceneView->viewport()->rect()).boundingRect();
-
-        // Ajustar a posição inicial da grade com base na posição da câmera
-        qreal startX = std::floor(visibleRect.left() / entitySize.width()) * entitySize.width();
-        qreal startY = std::floor(visibleRect.top() / entitySize.height()) * entitySize.height();
-
-        // Desenhar linhas verticais
-        for (qreal x = startX; x < visibleRect.right(); x += entitySize.width()) {
-            QGraphicsLineItem* line = m_scene->addLine(x, visibleRect.top(), x, visibleRect.bottom(), QPen(Qt::lightGray, 1, Qt::DotLine));
-            m_gridLines.append(line);
-        }
-
-        // Desenhar linhas horizontais
-        for (qreal y = startY; y < visibleRect.bottom(); y += entitySize.height()) {
-            QGraphicsLineItem* line = m_scene->addLine(visibleRect.left(), y, visibleRect.right(), y, QPen(Qt::lightGray, 1, Qt::DotLine));
-            m_gridLines.append(line);
-        }
-
-        qCInfo(mainWindowCategory) << "Grade atualizada com tamanho de célula:" << entitySize;
-    }
+    TraceSpan span("MainWindow::updateGrid", "ui");
+    // Mostrar a grade apenas quando o Shift estiver pressionado; a view só repinta se a célula mudar
+    const QSizeF cellSize = m_shiftPressed && m_selectedEntity ? SceneModel::placementSize(m_selectedEntity) : QSizeF();
+    m_sceneView->setGridCellSize(cellSize);
 }
 
 void MainWindow::wheelEvent(QWheelEvent* event)
@@ -361,7 +361,6 @@ void MainWindow::wheelEvent(QWheelEvent* event)
             scaleFactor = 1.0 / scaleFactor;
         }
         m_sceneView->scale(scaleFactor, scaleFactor);
-        updateGrid(); // Atualizar a grade após o zoom
     } else {
         // Scroll padrão
         QMainWindow::wheelEvent(event);
@@ -444,6 +443,7 @@ void MainWindow::activateBrushTool()
     clearSelection();
     updatePaintingMode();
     m_sceneView->setDragMode(QGraphicsView::NoDrag);
+    m_tileLayer->setInteractive(false);
     m_sceneView->setCursor(Qt::CrossCursor);
     if (m_previewItem) {
         m_previewItem->show();
@@ -483,11 +483,7 @@ void MainWindow::createActions()
                                                         QDir::homePath(),
                                                         QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
         if (!dir.isEmpty()) {
-            m_projectPath = dir;
-            m_fileSystemModel->setRootPath(m_projectPath);
-            m_projectExplorer->setRootIndex(m_fileSystemModel->index(m_projectPath));
-            statusBar()->showMessage("Project opened: " + m_projectPath);
-            loadEntities();
+            openProject(dir);
         }
     });
 
@@ -509,6 +505,10 @@ void MainWindow::createActions()
     QAction *exportAction = new QAction("Export Scene", this);
     connect(exportAction, &QAction::triggered, this, &MainWindow::exportScene);
 
+    // Ação para converter entre .esc e .escb
+    QAction *convertAction = new QAction("Convert Scene...", this);
+    connect(convertAction, &QAction::triggered, this, &MainWindow::convertScene);
+
     // Criar o menu File
     QMenu *fileMenu = menuBar()->addMenu("&File");
     fileMenu->addAction(openProjectAction);
@@ -516,11 +516,112 @@ void MainWindow::createActions()
     fileMenu->addAction(saveAsAction);
     fileMenu->addAction(importAction);
     fileMenu->addAction(exportAction);
+    fileMenu->addAction(convertAction);
+
+    // Ação para limitar a memória do histórico
+    QAction *undoLimitAction = new QAction("Undo Memory Limit...", this);
+    connect(undoLimitAction, &QAction::triggered, this, [this]() {
+        bool ok = false;
+        int megabytes = QInputDialog::getInt(this, "Undo Memory Limit", "Limite de memória do histórico (MB):",
+                                             static_cast<int>(m_sceneModel->history().memoryLimitBytes() / (1024 * 1024)),
+                                             1, 4096, 1, &ok);
+        if (ok) {
+            m_sceneModel->history().setMemoryLimitBytes(static_cast<qint64>(megabytes) * 1024 * 1024);
+            updateUndoStatus();
+            qCInfo(mainWindowCategory) << "Limite de memória do histórico:" << megabytes << "MB";
+        }
+    });
 
     // Criar o menu Edit
     QMenu *editMenu = menuBar()->addMenu("&Edit");
     editMenu->addAction(undoAction);
     editMenu->addAction(redoAction);
+    editMenu->addSeparator();
+    editMenu->addAction(undoLimitAction);
+
+    // Gravação de trace: ao desligar, o trace vai para um .json que abre no Perfetto
+    QAction *traceAction = new QAction("Record Trace", this);
+    traceAction->setCheckable(true);
+    traceAction->setShortcut(QKeySequence::fromString("Ctrl+Alt+T"));
+    connect(traceAction, &QAction::toggled, this, &MainWindow::setTraceRecording);
+
+    // HUD de desempenho sobre a cena, leve o bastante para deixar ligado editando
+    QAction *hudAction = new QAction("Performance HUD", this);
+    hudAction->setCheckable(true);
+    hudAction->setShortcut(QKeySequence::fromString("Ctrl+Alt+H"));
+    connect(hudAction, &QAction::toggled, m_sceneView, &SceneView::setHudVisible);
+
+    // Atraso do MouseMove até o preview do pincel ser desenhado; o resumo vai para o log ao desligar
+    QAction *inputProbeAction = new QAction("Input Latency Probe", this);
+    inputProbeAction->setCheckable(true);
+    connect(inputProbeAction, &QAction::toggled, this, &MainWindow::setInputLatencyProbe);
+
+    QAction *dumpStatsAction = new QAction("Dump Performance Stats", this);
+    connect(dumpStatsAction, &QAction::triggered, this, &MainWindow::dumpPerformanceStats);
+
+    QMenu *debugMenu = menuBar()->addMenu("&Debug");
+    debugMenu->addAction(traceAction);
+    debugMenu->addSeparator();
+    debugMenu->addAction(hudAction);
+    debugMenu->addAction(inputProbeAction);
+    debugMenu->addAction(dumpStatsAction);
+    debugMenu->addAction(m_diagnosticsDock->toggleViewAction());
+    debugMenu->addAction(m_memoryDock->toggleViewAction());
+}
+
+void MainWindow::dumpPerformanceStats()
+{
+    // Mesmos números do HUD, com mais percentis; vão para o log e para a área de transferência
+    QString report = m_sceneView->hud().report();
+    const InputLatencyProbe &probe = m_sceneView->inputProbe();
+    if (probe.isEnabled() || probe.inputCount() > 0) {
+        report += '\n' + probe.report();
+    }
+    qCInfo(mainWindowCategory).noquote() << "Estatísticas de desempenho:\n" + report;
+    QGuiApplication::clipboard()->setText(report);
+    statusBar()->showMessage(tr("Estatísticas de desempenho copiadas e gravadas no log"), 5000);
+}
+
+void MainWindow::setInputLatencyProbe(bool enabled)
+{
+    InputLatencyProbe &probe = m_sceneView->inputProbe();
+    probe.setEnabled(enabled);
+    if (enabled) {
+        statusBar()->showMessage(tr("Medindo latência de entrada até pixel do pincel..."));
+        qCInfo(mainWindowCategory) << "Medição de latência de entrada iniciada";
+        return;
+    }
+
+    qCInfo(mainWindowCategory).noquote() << "Latência de entrada até pixel:\n" + probe.report();
+    statusBar()->showMessage(tr("Latência de entrada: p99 %1 ms em %2 quadros, %3 movimentos agrupados, %4 descartados")
+                                 .arg(probe.histogram().percentileNsecs(99) / 1e6, 0, 'f', 2)
+                                 .arg(probe.measuredCount()).arg(probe.coalescedCount())
+                                 .arg(probe.droppedCount()), 10000);
+}
+
+void MainWindow::setTraceRecording(bool enabled)
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.setEnabled(enabled);
+    if (enabled) {
+        statusBar()->showMessage(tr("Gravando trace..."));
+        qCInfo(mainWindowCategory) << "Gravação de trace iniciada";
+        return;
+    }
+
+    qCInfo(mainWindowCategory) << "Gravação de trace encerrada:" << recorder.eventCount() << "spans,"
+                               << recorder.droppedCount() << "descartados";
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("Salvar Trace"), "trace.json",
+                                                          tr("Trace do Chrome (*.json)"));
+    if (fileName.isEmpty()) {
+        statusBar()->clearMessage();
+        return;
+    }
+    if (!recorder.writeJson(fileName)) {
+        QMessageBox::warning(this, tr("Erro"), tr("Não foi possível gravar o trace: %1").arg(fileName));
+        return;
+    }
+    statusBar()->showMessage(tr("Trace com %1 spans salvo em %2").arg(recorder.eventCount()).arg(fileName), 5000);
 }
 
 void MainWindow::activateSelectTool()
@@ -528,6 +629,7 @@ void MainWindow::activateSelectTool()
     m_currentTool = SelectTool;
     updatePaintingMode();
     m_sceneView->setDragMode(QGraphicsView::RubberBandDrag);
+    m_tileLayer->setInteractive(true);
     m_sceneView->setCursor(Qt::ArrowCursor);
     clearPreview(); // Limpa qualquer preview existente
     updateToolbarState();
@@ -553,6 +655,15 @@ void MainWindow::loadEntities()
             return;
         }
 
+        // As colocações e os tiles em cache apontam para as entidades antigas
+        if (!confirmEntityReload()) {
+            qCInfo(mainWindowCategory) << "Recarga de entidades cancelada";
+            return;
+        }
+        clearCurrentScene();
+        m_tileCache->clear();
+        clearPreview();
+        m_previewPixmapEntity = nullptr;
         m_entityManager->loadEntitiesFromDirectory(entitiesPath);
 
         m_entityList->clear();
@@ -567,15 +678,44 @@ void MainWindow::loadEntities()
             qCWarning(mainWindowCategory) << "Nenhuma entidade foi carregada";
         } else {
             qCInfo(mainWindowCategory) << "Total de entidades carregadas:" << m_entityList->count();
+            const SpritesheetCache &spritesheets = m_entityManager->spritesheetCache();
+            qCInfo(mainWindowCategory) << "Spritesheets decodificados:" << spritesheets.decodedCount()
+                                       << "-" << spritesheets.decodedBytes() << "de" << spritesheets.budgetBytes() << "bytes";
         }
+
+        // A cena foi esvaziada: o journal recomeça sem cena de base, e o próximo save pede um
+        // nome em vez de gravar a cena vazia por cima do arquivo anterior
+        m_sceneModel->setScenePath(QString());
+        m_sceneModel->restartJournal(QString());
     } catch (const std::exception& e) {
         handleException("Erro ao carregar entidades", e);
     }
 }
 
+bool MainWindow::confirmEntityReload()
+{
+    if (!m_sceneModel->isModified()) {
+        return true;
+    }
+
+    const QMessageBox::StandardButton answer = QMessageBox::question(
+        this, tr("Recarregar entidades"),
+        tr("Recarregar as entidades esvazia a cena atual.\n\n"
+           "Salvar as alterações feitas desde o último save?"),
+        QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel, QMessageBox::Save);
+    if (answer == QMessageBox::Save) {
+        // Save cancelado ou com erro: a cena continua modificada e a recarga não acontece
+        saveScene();
+        return !m_sceneModel->isModified();
+    }
+    return answer == QMessageBox::Discard;
+}
+
 void MainWindow::onProjectItemDoubleClicked(const QModelIndex &index)
 {
+    TraceSpan span("MainWindow::onProjectItemDoubleClicked", "load");
     QString path = m_fileSystemModel->filePath(index);
+    span.addArg("path", path);
     qCInfo(mainWindowCategory) << "Arquivo clicado:" << path;
 
     // Se o item clicado for o diretório "entities", recarregue as entidades
@@ -597,7 +737,7 @@ void MainWindow::updatePreviewContinuously()
             qCDebug(mainWindowCategory) << "updatePreviewContinuously: Nenhuma entidade selecionada";
             return;
         }
-        if (!m_previewItem) {
+        if (!m_previewItem || !m_previewItem->isVisible()) {
             qCDebug(mainWindowCategory) << "updatePreviewContinuously: Nenhum item de preview";
             return;
         }
@@ -682,6 +822,7 @@ void MainWindow::ensureBrushToolActive()
 {
     if (m_currentTool != BrushTool) {
         m_currentTool = BrushTool;
+        m_tileLayer->setInteractive(false);
         // Atualize a interface do usuário para refletir a mudança de ferramenta
         updateToolbarState();
     }
@@ -704,6 +845,7 @@ void MainWindow::keyReleaseEvent(QKeyEvent *event)
 
 void MainWindow::onTileItemClicked(QListWidgetItem *item)
 {
+    COMMAND_LATENCY("onTileItemClicked");
     if (!item) {
         qCWarning(mainWindowCategory) << "Item de tile clicado é nulo";
         return;
@@ -767,52 +909,53 @@ void MainWindow::updateEntityPreview()
     }
 
     try {
-        QSizeF size = m_previewEntity->getCurrentSize();
-        if (size.isEmpty()) {
-            size = m_previewEntity->getCollisionSize();
-            if (size.isEmpty()) {
-                size = QSizeF(32, 32);
-            }
-        }
-
-        // Remover o preview existente, se houver
-        if (m_previewItem) {
-            m_scene->removeItem(m_previewItem);
-            delete m_previewItem;
-            m_previewItem = nullptr;
-        }
-
-        if (m_selectedEntity->isInvisible()) {
-            QGraphicsRectItem* invisiblePreview = new QGraphicsRectItem(QRectF(0, 0, size.width(), size.height()));
-            invisiblePreview->setPen(QPen(Qt::red, 2, Qt::DashLine));
-            invisiblePreview->setBrush(Qt::transparent);
-            invisiblePreview->setOpacity(0.5);
-            invisiblePreview->setZValue(1000);
-            m_previewItem = invisiblePreview;
-        } else {
-            QPixmap previewPixmap = createEntityPixmap(size, m_previewEntity, m_previewTileIndex);
-            QGraphicsPixmapItem* pixmapPreview = new QGraphicsPixmapItem(previewPixmap);
-            pixmapPreview->setOpacity(0.5);
-            pixmapPreview->setZValue(1000);
-            m_previewItem = pixmapPreview;
-        }
-
-        m_scene->addItem(m_previewItem);
-        m_previewItem->show();
+        // O item é reaproveitado; o pixmap só é refeito se a entidade, o tile ou o modo mudaram
+        refreshPreviewPixmap(m_selectedEntity, m_selectedTileIndex, m_ctrlPressed);
 
         // Atualizar a posição do preview
         updatePreviewPosition(m_lastCursorPosition);
 
         qCInfo(mainWindowCategory) << "Preview da entidade atualizado para" << m_selectedEntity->getName() 
-                                   << "com tamanho" << size << "e tile index" << m_selectedTileIndex;
+                                   << "com tile index" << m_selectedTileIndex;
 
     } catch (const std::exception& e) {
         handleException("Erro ao atualizar preview da entidade", e);
     }
 }
 
+void MainWindow::refreshPreviewPixmap(Entity* entity, int tileIndex, bool erase)
+{
+    if (!m_previewItem || !entity) {
+        return;
+    }
+
+    // Na borracha o pixmap não depende da entidade nem do tile
+    const bool unchanged = erase == m_previewPixmapErase
+                           && (erase || (entity == m_previewPixmapEntity && tileIndex == m_previewPixmapTileIndex));
+    if (unchanged) {
+        return;
+    }
+
+    if (erase) {
+        m_previewItem->setPixmap(createErasePreviewPixmap());
+        m_previewItem->setOpacity(1.0);  // Totalmente visível no modo de apagar
+    } else {
+        const QSizeF size = SceneModel::placementSize(entity);
+        m_previewItem->setPixmap(entity->isInvisible() ? createInvisiblePreviewPixmap(size)
+                                                       : createEntityPixmap(size, entity, tileIndex));
+        m_previewItem->setOpacity(0.5);
+    }
+
+    m_previewPixmapEntity = entity;
+    m_previewPixmapTileIndex = tileIndex;
+    m_previewPixmapErase = erase;
+    m_previewEntity = entity;
+    m_previewTileIndex = tileIndex;
+}
+
 void MainWindow::onEntityItemClicked(QListWidgetItem *item)
 {
+    COMMAND_LATENCY("onEntityItemClicked");
     clearPreview(); // Limpa a pré-visualização anterior
 
     if (!item) {
@@ -833,6 +976,13 @@ void MainWindow::onEntityItemClicked(QListWidgetItem *item)
         m_previewEntity = m_selectedEntity;
         m_previewTileIndex = m_selectedTileIndex;
         updateEntityPreview();
+
+        // Renderizar os demais tiles da entidade em background antes de serem pintados
+        // Mesmo tamanho das colocações, para os tiles pré-renderizados serem os usados no desenho
+        m_tileCache->prewarm(m_selectedEntity, SceneModel::placementSize(m_selectedEntity).toSize());
+        qCInfo(mainWindowCategory) << "Cache de tiles - acertos:" << m_tileCache->hits()
+                                   << "faltas:" << m_tileCache->misses()
+                                   << "pixmaps:" << m_tileCache->count();
         
         m_selectedTileIndex = 0;
         updateEntityPreview();
@@ -854,131 +1004,66 @@ void MainWindow::onEntityItemClicked(QListWidgetItem *item)
 
 void MainWindow::importScene()
 {
-    QString fileName = QFileDialog::getOpenFileName(this, tr("Importar Cena"), "", tr("Arquivos de Cena (*.esc);;Todos os Arquivos (*)"));
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Importar Cena"), "",
+                                                    tr("Arquivos de Cena (*.esc *.escb);;Todos os Arquivos (*)"));
     if (fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, tr("Erro"), tr("Não foi possível abrir o arquivo para leitura."));
+    openScene(fileName);
+}
+
+void MainWindow::openScene(const QString &fileName)
+{
+    // Sem o diálogo de arquivo, só a importação e a atualização da janela
+    COMMAND_LATENCY("importScene");
+    SceneModel::FileStats stats;
+    if (!m_sceneModel->importScene(fileName, &stats)) {
+        QMessageBox::warning(this, tr("Erro"), m_sceneModel->errorString());
         return;
     }
+    m_currentSelectedPlacement = PlacementStore::InvalidHandle;
 
-    clearCurrentScene();
+    const int entitiesPerSecond = stats.elapsedMs > 0 ? qRound(stats.entityCount * 1000.0 / stats.elapsedMs)
+                                                      : stats.entityCount;
+    qCInfo(mainWindowCategory) << "Importação:" << stats.entityCount << "entidades em" << stats.elapsedMs << "ms -"
+                               << entitiesPerSecond << "entidades/s -" << stats.missingCount << "não encontradas";
 
-    QXmlStreamReader xml(&file);
-
-    while (!xml.atEnd() && !xml.hasError()) {
-        QXmlStreamReader::TokenType token = xml.readNext();
-
-        if (token == QXmlStreamReader::StartElement) {
-            if (xml.name().compare(QLatin1String("Entity")) == 0) {
-                QString entityName;
-                QPointF position;
-                int spriteFrame = 0;
-
-                QXmlStreamAttributes attributes = xml.attributes();
-                if (attributes.hasAttribute(QLatin1String("spriteFrame"))) {
-                    spriteFrame = attributes.value(QLatin1String("spriteFrame")).toInt();
-                }
-
-                while (!(xml.tokenType() == QXmlStreamReader::EndElement && 
-                         xml.name().compare(QLatin1String("Entity")) == 0)) {
-                    xml.readNext();
-
-                    if (xml.tokenType() == QXmlStreamReader::StartElement) {
-                        if (xml.name().compare(QLatin1String("EntityName")) == 0) {
-                            entityName = xml.readElementText().replace(QLatin1String(".ent"), QString());
-                        } else if (xml.name().compare(QLatin1String("Position")) == 0) {
-                            QXmlStreamAttributes posAttributes = xml.attributes();
-                            qreal x = posAttributes.value(QLatin1String("x")).toDouble();
-                            qreal y = posAttributes.value(QLatin1String("y")).toDouble();
-                            position = QPointF(x, y);
-                        }
-                    }
-                }
-
-                Entity* entity = m_entityManager->getEntityByName(entityName);
-                if (entity) {
-                    QSizeF entitySize = entity->getCurrentSize();
-                    if (entitySize.isEmpty()) {
-                        entitySize = entity->getCollisionSize();
-                        if (entitySize.isEmpty()) {
-                            entitySize = QSizeF(32, 32);
-                        }
-                    }
-                    QPointF correctedPos = position - QPointF(entitySize.width() / 2, entitySize.height() / 2);
-                    
-                    // Verificar se o spriteFrame é válido
-                    if (spriteFrame < 0 || spriteFrame >= entity->getSpriteDefinitions().size()) {
-                        spriteFrame = 0;
-                    }
-                    
-                    // Usar uma função separada para colocar a entidade na cena
-                    placeImportedEntityInScene(correctedPos, entity, spriteFrame);
-                } else {
-                    qCWarning(mainWindowCategory) << "Entidade não encontrada:" << entityName;
-                }
-            }
-        }
-    }
-
-    if (xml.hasError()) {
-        QMessageBox::warning(this, tr("Erro de XML"), tr("Erro ao ler o arquivo XML: %1").arg(xml.errorString()));
+    // Erro no meio do XML: o que foi lido até ali fica na cena
+    if (!m_sceneModel->errorString().isEmpty()) {
+        QMessageBox::warning(this, tr("Erro de XML"), m_sceneModel->errorString());
     }
 
-    file.close();
     updateGrid();
+    statusBar()->showMessage(tr("%1 entidades importadas em %2 ms (%3 entidades/s)")
+                                 .arg(stats.entityCount).arg(stats.elapsedMs).arg(entitiesPerSecond), 5000);
     QMessageBox::information(this, tr("Sucesso"), tr("Cena importada com sucesso."));
 
-    m_currentScenePath = fileName;
-    qCInfo(mainWindowCategory) << "Cena importada de:" << m_currentScenePath;    
+    qCInfo(mainWindowCategory) << "Cena importada de:" << m_sceneModel->scenePath();
 }
 
-void MainWindow::placeImportedEntityInScene(const QPointF &pos, Entity* entity, int tileIndex)
+void MainWindow::clearCurrentScene()
 {
-    if (!entity) {
-        qCWarning(mainWindowCategory) << "Tentativa de colocar entidade nula na cena";
-        return;
-    }
-
-    QSizeF entitySize = entity->getCurrentSize();
-    if (entitySize.isEmpty()) {
-        entitySize = entity->getCollisionSize();
-        if (entitySize.isEmpty()) {
-            entitySize = QSizeF(32, 32);
-        }
-    }
+    m_sceneModel->clear();
+    m_currentSelectedPlacement = PlacementStore::InvalidHandle;
+}
 
-    QPixmap tilePixmap = createEntityPixmap(entitySize, entity, tileIndex);
-    QGraphicsPixmapItem *item = m_scene->addPixmap(tilePixmap);
-    if (!item) {
-        qCWarning(mainWindowCategory) << "Falha ao adicionar item à cena";
+void MainWindow::onPlacementsChanged(const QRectF &area)
+{
+    if (!m_tileLayer) {
         return;
     }
-    item->setPos(pos);
-    item->setFlag(QGraphicsItem::ItemIsMovable);
-    item->setFlag(QGraphicsItem::ItemIsSelectable);
-
-    EntityPlacement placement;
-    placement.entity = entity;
-    placement.tileIndex = tileIndex;
-    m_entityPlacements[item] = placement;
-
-    qCInfo(mainWindowCategory) << "Entidade importada colocada na cena:" << entity->getName() 
-                               << "na posição:" << pos 
-                               << "com tile index:" << tileIndex;
+    if (area.isNull()) {
+        m_tileLayer->placementsChanged();
+    } else {
+        m_tileLayer->placementsChanged(area);
+    }
 }
 
-void MainWindow::clearCurrentScene()
+void MainWindow::onPlacementRemoved(int handle)
 {
-    for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end(); ++it) {
-        m_scene->removeItem(it.key());
-        delete it.key();
+    if (handle == m_currentSelectedPlacement) {
+        m_currentSelectedPlacement = PlacementStore::InvalidHandle;
     }
-    m_entityPlacements.clear();
-    undoStack.clear();
-    redoStack.clear();
 }
 
 void MainWindow::updatePreviewPosition(const QPointF& scenePos)
@@ -990,67 +1075,45 @@ void MainWindow::updatePreviewPosition(const QPointF& scenePos)
 
     m_lastCursorPosition = scenePos;
     if (!m_selectedEntity || !m_previewItem) {
-        if (m_selectedEntity && !m_previewItem) {
-            updateEntityPreview();
-        }
-        if (!m_selectedEntity || !m_previewItem) {
-            qCWarning(mainWindowCategory) << "updatePreviewPosition: m_selectedEntity ou m_previewItem é nulo";
-            return;
-        }
+        SCENE_LOG_TRACE(mainWindowLog) << "updatePreviewPosition: m_selectedEntity ou m_previewItem é nulo";
+        m_sceneView->inputProbe().dropPending();
+        return;
     }
 
+    // Nada a fazer enquanto a entidade, o tile e o Ctrl forem os mesmos
+    refreshPreviewPixmap(m_selectedEntity, m_selectedTileIndex, m_ctrlPressed);
+
     QPointF adjustedPos = scenePos;
     if (m_shiftPressed) {
-        QSizeF entitySize = m_selectedEntity->getCurrentSize();
-        if (entitySize.isEmpty()) {
-            entitySize = m_selectedEntity->getCollisionSize();
-            if (entitySize.isEmpty()) {
-                entitySize = QSizeF(32, 32);
-            }
-        }
-        qreal gridX = qRound(scenePos.x() / entitySize.width()) * entitySize.width();
-        qreal gridY = qRound(scenePos.y() / entitySize.height()) * entitySize.height();
-        adjustedPos = QPointF(gridX, gridY);
+        adjustedPos = SceneModel::snapToEntityGrid(scenePos, SceneModel::placementSize(m_selectedEntity));
     }
-
     if (m_ctrlPressed) {
-        // Usar o mesmo preview de borracha para todos os tipos de entidades
-        QPixmap erasePixmap = createErasePreviewPixmap();
-        if (QGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<QGraphicsPixmapItem*>(m_previewItem)) {
-            pixmapItem->setPixmap(erasePixmap);
-        } else if (QGraphicsRectItem* rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(m_previewItem)) {
-            // Remover o retângulo existente e substituí-lo por um QGraphicsPixmapItem
-            m_scene->removeItem(m_previewItem);
-            delete m_previewItem;
-            m_previewItem = m_scene->addPixmap(erasePixmap);
-            m_previewItem->setZValue(1000);
-        }
         adjustedPos -= QPointF(16, 16);  // Centraliza o preview da borracha
-        m_previewItem->setOpacity(1.0);  // Totalmente visível no modo de apagar
-    } else {
-        QSizeF entitySize = m_selectedEntity->getCurrentSize();
-        if (entitySize.isEmpty()) {
-            entitySize = m_selectedEntity->getCollisionSize();
-            if (entitySize.isEmpty()) {
-                entitySize = QSizeF(32, 32);
-            }
-        }
-        if (QGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<QGraphicsPixmapItem*>(m_previewItem)) {
-            pixmapItem->setPixmap(createEntityPixmap(entitySize, m_selectedEntity, m_selectedTileIndex));
-        } else if (QGraphicsRectItem* rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(m_previewItem)) {
-            rectItem->setRect(QRectF(0, 0, entitySize.width(), entitySize.height()));
-            rectItem->setPen(QPen(Qt::red, 2, Qt::DashLine));
-            rectItem->setBrush(Qt::transparent);
-        }
-        m_previewItem->setOpacity(0.5);  // Opacidade normal
     }
+    m_pendingPreviewPos = adjustedPos;
+
+    if (!m_previewItem->isVisible()) {
+        // Reaparecendo: já na posição certa, sem esperar o próximo quadro
+        applyPendingPreviewPosition();
+        m_previewItem->show();
+    } else if (!m_previewPositionTimer->isActive()) {
+        m_previewPositionTimer->start();
+    }
+}
 
-    m_previewItem->setPos(adjustedPos);
-    m_previewItem->show();
+void MainWindow::applyPendingPreviewPosition()
+{
+    m_previewPositionTimer->stop();
+    if (!m_previewItem || m_previewItem->pos() == m_pendingPreviewPos) {
+        m_sceneView->inputProbe().dropPending();
+        return;
+    }
+    m_previewItem->setPos(m_pendingPreviewPos);
+    m_sceneView->inputProbe().moveApplied();
 
-    qCInfo(mainWindowCategory) << "Preview atualizado para posição:" << adjustedPos 
-                               << "Shift:" << m_shiftPressed 
-                               << "Ctrl:" << m_ctrlPressed;
+    SCENE_LOG_TRACE(mainWindowLog) << "Preview atualizado para posição:" << m_pendingPreviewPos
+                                   << "Shift:" << m_shiftPressed
+                                   << "Ctrl:" << m_ctrlPressed;
 }
 
 void MainWindow::clearPreviewIfNotBrushTool()
@@ -1069,7 +1132,7 @@ void MainWindow::recoverSceneState()
         }
     }
 
-    if (!m_previewItem && m_selectedEntity) {
+    if (m_selectedEntity && m_previewItem && !m_previewItem->isVisible()) {
         updateEntityPreview();
     }
 
@@ -1098,11 +1161,14 @@ void MainWindow::drawGridOnSpritesheet()
 
 void MainWindow::updateTileList()
 {
+    TraceSpan span("MainWindow::updateTileList", "ui");
     m_tileList->clear();
     if (!m_selectedEntity) {
         qCWarning(mainWindowCategory) << "Nenhuma entidade selecionada para atualizar a lista de tiles";
         return;
     }
+    span.addArg("entity", m_selectedEntity->getName());
+    span.addArg("tiles", m_selectedEntity->getSpriteDefinitions().size());
 
     try {
         QPixmap entityPixmap;
@@ -1147,14 +1213,14 @@ void MainWindow::updateTileList()
                 QListWidgetItem* item = new QListWidgetItem(QString("Tile %1").arg(i));
                 item->setData(Qt::UserRole, i);
                 m_tileList->addItem(item);
-                qCInfo(mainWindowCategory) << "Adicionado tile" << i << ":" << spriteDefinitions[i];
+                SCENE_LOG_TRACE(mainWindowLog) << "Adicionado tile" << i << ":" << spriteDefinitions[i];
             }
         }
 
-        qCInfo(mainWindowCategory) << "Spritesheet atualizado e lista de tiles preenchida";
-        qCInfo(mainWindowCategory) << "Número de tiles:" << (m_selectedEntity->isInvisible() ? 1 : spriteDefinitions.size());
-        qCInfo(mainWindowCategory) << "Tamanho do pixmap:" << entityPixmap.size();
-        qCInfo(mainWindowCategory) << "Entidade é invisível:" << m_selectedEntity->isInvisible();
+        SCENE_LOG_DEBUG(mainWindowLog) << "Spritesheet atualizado e lista de tiles preenchida";
+        SCENE_LOG_DEBUG(mainWindowLog) << "Número de tiles:" << (m_selectedEntity->isInvisible() ? 1 : spriteDefinitions.size());
+        SCENE_LOG_DEBUG(mainWindowLog) << "Tamanho do pixmap:" << entityPixmap.size();
+        SCENE_LOG_DEBUG(mainWindowLog) << "Entidade é invisível:" << m_selectedEntity->isInvisible();
     } catch (const std::exception& e) {
         handleException("Erro ao atualizar lista de tiles", e);
     }
@@ -1177,53 +1243,51 @@ void MainWindow::changeEvent(QEvent *event)
 
 void MainWindow::clearPreview()
 {
+    // Só esconde: o item e o pixmap ficam prontos para a próxima vez
+    if (m_previewPositionTimer) {
+        m_previewPositionTimer->stop();
+    }
     if (m_previewItem) {
-        m_scene->removeItem(m_previewItem);
-        delete m_previewItem;
-        m_previewItem = nullptr;
+        m_previewItem->hide();
+    }
+    if (m_sceneView) {
+        m_sceneView->inputProbe().discard();
     }
 }
 
 void MainWindow::paintWithBrush(const QPointF &pos)
 {
-    if (!m_selectedEntity || !m_previewItem) {
-        qCInfo(mainWindowCategory) << "paintWithBrush: Nenhuma entidade selecionada ou sem preview";
+    COMMAND_LATENCY("paintWithBrush");
+    if (!m_selectedEntity || !m_previewItem || !m_previewItem->isVisible()) {
+        SCENE_LOG_DEBUG(mainWindowLog) << "paintWithBrush: Nenhuma entidade selecionada ou sem preview";
         return;
     }
 
-    QSizeF entitySize = m_selectedEntity->getCurrentSize();
-    if (entitySize.isEmpty()) {
-        entitySize = m_selectedEntity->getCollisionSize();
-        if (entitySize.isEmpty()) {
-            entitySize = QSizeF(32, 32);
-        }
-    }
+    const QSizeF entitySize = SceneModel::placementSize(m_selectedEntity);
 
     QPointF finalPos = pos;
     QPair<int, int> gridPos;
 
     if (m_shiftPressed) {
-        int gridX = qRound(pos.x() / entitySize.width());
-        int gridY = qRound(pos.y() / entitySize.height());
-        gridPos = qMakePair(gridX, gridY);
-        finalPos = QPointF(gridX * entitySize.width(), gridY * entitySize.height());
+        finalPos = SceneModel::snapToEntityGrid(pos, entitySize);
+        gridPos = qMakePair(qRound(finalPos.x() / entitySize.width()), qRound(finalPos.y() / entitySize.height()));
     } else {
         gridPos = qMakePair(qRound(pos.x()), qRound(pos.y()));
     }
 
-    qCInfo(mainWindowCategory) << "paintWithBrush: Tentando colocar entidade em" << finalPos << "Modo de pintura:" << m_paintingMode;
+    SCENE_LOG_DEBUG(mainWindowLog) << "paintWithBrush: Tentando colocar entidade em" << finalPos << "Modo de pintura:" << m_paintingMode;
 
     bool canPlace = true;
 
     if (m_paintingMode && m_occupiedPositions.contains(gridPos)) {
-        qCInfo(mainWindowCategory) << "Entidade já existe na posição:" << finalPos << "(Modo de pintura)";
+        SCENE_LOG_DEBUG(mainWindowLog) << "Entidade já existe na posição:" << finalPos << "(Modo de pintura)";
         canPlace = false;
     }
 
     if (canPlace) {
-        QGraphicsItem* newItem = placeEntityInScene(finalPos);
-        if (newItem) {
-            qCInfo(mainWindowCategory) << "Nova entidade adicionada na posição:" << newItem->pos();
+        int newHandle = placeEntityInScene(finalPos);
+        if (newHandle != PlacementStore::InvalidHandle) {
+            SCENE_LOG_DEBUG(mainWindowLog) << "Nova entidade adicionada na posição:" << m_sceneModel->placements().at(newHandle).pos();
             if (m_paintingMode) {
                 m_occupiedPositions.insert(gridPos, true);
             }
@@ -1231,7 +1295,7 @@ void MainWindow::paintWithBrush(const QPointF &pos)
             qCWarning(mainWindowCategory) << "Falha ao adicionar nova entidade na posição:" << finalPos;
         }
     } else {
-        qCInfo(mainWindowCategory) << "Não foi possível colocar a entidade na posição:" << finalPos;
+        SCENE_LOG_DEBUG(mainWindowLog) << "Não foi possível colocar a entidade na posição:" << finalPos;
     }
 }
 
@@ -1255,41 +1319,6 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
         }
     }
 
-    if (watched == m_scene) {
-        if (event->type() == QEvent::GraphicsSceneMousePress) {
-            QGraphicsSceneMouseEvent *mouseEvent = static_cast<QGraphicsSceneMouseEvent*>(event);
-            QGraphicsItem *item = m_scene->itemAt(mouseEvent->scenePos(), QTransform());
-            if (item && item->flags() & QGraphicsItem::ItemIsMovable) {
-                if (QGraphicsRectItem *rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(item)) {
-                    m_movingItem = rectItem;
-                } else if (QGraphicsPixmapItem *pixmapItem = qgraphicsitem_cast<QGraphicsPixmapItem*>(item)) {
-                    m_movingItem = pixmapItem;
-                }
-                if (m_movingItem) {
-                    m_oldPosition = m_movingItem->pos();
-                    qCDebug(mainWindowCategory) << "Iniciando potencial movimento de item na posição:" << m_oldPosition;
-                }
-            }
-        } else if (event->type() == QEvent::GraphicsSceneMouseRelease) {
-            if (m_movingItem) {
-                QPointF newPosition = m_movingItem->pos();
-                if (newPosition != m_oldPosition) {
-                    Action action;
-                    action.type = Action::MOVE;
-                    action.entity = m_entityPlacements[m_movingItem].entity;
-                    action.tileIndex = m_entityPlacements[m_movingItem].tileIndex;
-                    action.oldPos = m_oldPosition;
-                    action.newPos = newPosition;
-                    addAction(action);
-                    qCDebug(mainWindowCategory) << "Movimento de item finalizado. Nova posição:" << newPosition;
-                } else {
-                    qCDebug(mainWindowCategory) << "Item clicado, mas não movido. Posição:" << newPosition;
-                }
-                m_movingItem = nullptr;
-            }
-        }
-    }
-    
     if (watched == m_sceneView->viewport()) {
         if (event->type() == QEvent::MouseMove) {
             QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
@@ -1297,6 +1326,7 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
             m_lastCursorPosition = scenePos;
             
             if (m_currentTool == BrushTool) {
+                m_sceneView->inputProbe().inputReceived();
                 updatePreviewPosition(scenePos);
                 if (mouseEvent->buttons() & Qt::LeftButton) {
                     if (m_ctrlPressed) {
@@ -1305,15 +1335,25 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
                         paintWithBrush(scenePos);
                     }
                 }
+                return true;
             } else if (m_currentTool == SelectTool) {
+                // Não consome o evento: a camada de tiles e o rubber band precisam dele
                 updateCursor(scenePos);
             }
-            return true;
         } else if (event->type() == QEvent::MouseButtonPress) {
             QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
             if (mouseEvent->button() == Qt::LeftButton) {
                 QPointF scenePos = m_sceneView->mapToScene(mouseEvent->pos());
                 if (m_currentTool == BrushTool) {
+                    if (mouseEvent->modifiers() & Qt::AltModifier) {
+                        pickEntityAt(scenePos);
+                        return true;
+                    }
+                    // O traço inteiro (pintura ou borracha) vira um passo do histórico
+                    if (!m_brushStrokeOpen) {
+                        m_sceneModel->beginStep();
+                        m_brushStrokeOpen = true;
+                    }
                     if (m_ctrlPressed) {
                         eraseEntity();
                     } else {
@@ -1321,10 +1361,20 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
                     }
                     return true;
                 } else if (m_currentTool == SelectTool) {
-                    // Lógica para selecionar entidades (mantenha o código existente)
+                    // Clique fora das colocações limpa a seleção; o resto fica com a camada de tiles
+                    if (!(mouseEvent->modifiers() & Qt::ControlModifier)
+                        && m_sceneModel->placements().topmostAt(scenePos) == PlacementStore::InvalidHandle) {
+                        clearSelection();
+                    }
                 }
             }
-        } 
+        } else if (event->type() == QEvent::MouseButtonRelease) {
+            QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+            if (mouseEvent->button() == Qt::LeftButton && m_brushStrokeOpen) {
+                m_sceneModel->endStep();
+                m_brushStrokeOpen = false;
+            }
+        }
     } else if (watched == m_spritesheetLabel && event->type() == QEvent::MouseButtonPress) {
         QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
         if (mouseEvent->button() == Qt::LeftButton) {
@@ -1338,7 +1388,11 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 void MainWindow::clearSelection()
 {
     m_scene->clearSelection();
-    m_currentSelectedItem = nullptr;
+    m_sceneModel->placements().clearSelection();
+    if (m_tileLayer) {
+        m_tileLayer->update();
+    }
+    m_currentSelectedPlacement = PlacementStore::InvalidHandle;
     updatePropertiesPanel();
     qCInfo(mainWindowCategory) << "Seleção limpa";
 }
@@ -1370,8 +1424,7 @@ void MainWindow::handleArrowKeyPress(QKeyEvent *event)
 void MainWindow::updateCursor(const QPointF& scenePos)
 {
     if (m_currentTool == SelectTool) {
-        QGraphicsItem *item = m_scene->itemAt(scenePos, QTransform());
-        if (item) {
+        if (m_sceneModel->placements().topmostAt(scenePos) != PlacementStore::InvalidHandle) {
             m_sceneView->setCursor(Qt::PointingHandCursor);
         } else {
             m_sceneView->setCursor(Qt::ArrowCursor);
@@ -1417,7 +1470,8 @@ void MainWindow::onSceneViewMousePress(QMouseEvent *event)
     }
 }
 
-QGraphicsItem* MainWindow::placeEntityInScene(const QPointF &pos, bool addToUndoStack, Entity* entity, int tileIndex, bool updatePreview)
+int MainWindow::placeEntityInScene(const QPointF &pos, bool addToUndoStack, Entity* entity, int tileIndex, bool updatePreview,
+                                   quint64 placementId)
 {
     if (!entity) {
         entity = m_selectedEntity;
@@ -1426,93 +1480,57 @@ QGraphicsItem* MainWindow::placeEntityInScene(const QPointF &pos, bool addToUndo
 
     if (!entity) {
         qCWarning(mainWindowCategory) << "Nenhuma entidade selecionada para colocar na cena";
-        return nullptr;
+        return PlacementStore::InvalidHandle;
     }
 
+    COMMAND_LATENCY("placeEntityInScene");
+    TraceSpan span("MainWindow::placeEntityInScene", "edit");
+    span.addArg("entity", entity->getName());
+    span.addArg("tile", tileIndex);
+
     if (updatePreview) {
         updateEntityPreview();
     }
 
     try {
-        qCInfo(mainWindowCategory) << "Iniciando colocação de entidade:" << entity->getName();
-        qCInfo(mainWindowCategory) << "Posição inicial:" << pos;
-        qCInfo(mainWindowCategory) << "Entidade é invisível:" << entity->isInvisible();
-
-        QSizeF entitySize = entity->getCurrentSize();
-        if (entitySize.isEmpty()) {
-            entitySize = entity->getCollisionSize();
-            if (entitySize.isEmpty()) {
-                entitySize = QSizeF(32, 32);
-            }
-        }
+        SCENE_LOG_DEBUG(mainWindowLog) << "Iniciando colocação de entidade:" << entity->getName();
+        SCENE_LOG_DEBUG(mainWindowLog) << "Posição inicial:" << pos;
+        SCENE_LOG_DEBUG(mainWindowLog) << "Entidade é invisível:" << entity->isInvisible();
+
+        const QSizeF entitySize = SceneModel::placementSize(entity);
 
         QPointF finalPos = pos;
         
         if (m_shiftPressed) {
-            qreal gridX = qRound(pos.x() / entitySize.width()) * entitySize.width();
-            qreal gridY = qRound(pos.y() / entitySize.height()) * entitySize.height();
-            finalPos = QPointF(gridX, gridY);
+            finalPos = SceneModel::snapToEntityGrid(pos, entitySize);
         }
 
-        QGraphicsItem* item;
-        if (entity->isInvisible()) {
-            QGraphicsRectItem* invisibleItem = new QGraphicsRectItem(QRectF(0, 0, entitySize.width(), entitySize.height()));
-            invisibleItem->setPen(QPen(Qt::red, 2, Qt::DashLine));
-            invisibleItem->setBrush(Qt::transparent);
-            invisibleItem->setPos(finalPos);
-            invisibleItem->setFlag(QGraphicsItem::ItemIsSelectable);
-            invisibleItem->setFlag(QGraphicsItem::ItemIsMovable);
-            m_scene->addItem(invisibleItem);
-            item = invisibleItem;
-        } else {
-            QPixmap tilePixmap = createEntityPixmap(entitySize, entity, tileIndex);
-            QGraphicsPixmapItem *pixmapItem = m_scene->addPixmap(tilePixmap);
-            pixmapItem->setPos(finalPos);
-            pixmapItem->setFlag(QGraphicsItem::ItemIsMovable);
-            pixmapItem->setFlag(QGraphicsItem::ItemIsSelectable);
-            item = pixmapItem;
+        // Invisíveis, só colisão e sprites são todos desenhados pela camada de tiles
+        int handle = m_sceneModel->addPlacement(entity, tileIndex, finalPos, addToUndoStack, placementId);
+        if (handle == PlacementStore::InvalidHandle) {
+            return PlacementStore::InvalidHandle;
         }
-
-        EntityPlacement placement;
-        placement.entity = entity;
-        placement.tileIndex = tileIndex;
-        placement.item = item;
-        m_entityPlacements[item] = placement;
-        qCInfo(mainWindowCategory) << "Entidade adicionada ao m_entityPlacements:" 
-                           << entity->getName() << "na posição:" << item->pos();
-
-        // qCInfo(mainWindowCategory) << "Placement adicionado ao mapa de entidades. Total de placements:" << m_entityPlacements.size();
-
-        // Adicionar ação para Undo/Redo apenas se addToUndoStack for true
+        SCENE_LOG_DEBUG(mainWindowLog) << "Entidade adicionada à cena:" 
+                           << entity->getName() << "na posição:" << m_sceneModel->placements().at(handle).pos();
         if (addToUndoStack) {
-            Action action;
-            action.type = Action::ADD;
-            action.entity = entity;
-            action.tileIndex = tileIndex;
-            action.newPos = finalPos;
-            addAction(action);
-            qCInfo(mainWindowCategory) << "Ação adicionada para Undo/Redo. Tamanho da pilha de undo:" << undoStack.size();
+            SCENE_LOG_DEBUG(mainWindowLog) << "Ação adicionada para Undo/Redo. Tamanho da pilha de undo:" << m_sceneModel->history().undoCount();
         }
 
         updateGrid();
-        qCInfo(mainWindowCategory) << "Grade atualizada";
-
-        // Atualizar o preview após colocar a entidade
-        updateEntityPreview();
-        qCInfo(mainWindowCategory) << "Preview da entidade atualizado";
+        SCENE_LOG_TRACE(mainWindowLog) << "Grade atualizada";
 
-        qCInfo(mainWindowCategory) << "Entidade colocada na cena na posição:" << finalPos << "com tamanho:" << entitySize;
-        logToFile("Entidade colocada na cena: " + entity->getName());
+        SCENE_LOG_INFO(mainWindowLog) << "Entidade colocada na cena:" << entity->getName() << "na posição:" << finalPos
+                                     << "com tamanho:" << entitySize;
 
-        qCInfo(mainWindowCategory) << "Método placeEntityInScene concluído com sucesso";
+        SCENE_LOG_TRACE(mainWindowLog) << "Método placeEntityInScene concluído com sucesso";
 
-        return item;
+        return handle;
         
     } catch (const std::exception& e) {
         handleException("Erro ao colocar entidade na cena", e);
     }
 
-    return nullptr; 
+    return PlacementStore::InvalidHandle;
 }
 
 void MainWindow::updatePreviewIfNeeded()
@@ -1527,74 +1545,26 @@ void MainWindow::updatePreviewIfNeeded()
 
 QPixmap MainWindow::createEntityPixmap(const QSizeF &size, Entity* entity, int tileIndex)
 {
-    QPixmap pixmap(size.toSize());
-    pixmap.fill(Qt::transparent);
-    QPainter painter(&pixmap);
-
-    qCInfo(mainWindowCategory) << "Criando pixmap com tamanho:" << size << "e tile index:" << tileIndex;
+    SCENE_LOG_TRACE(mainWindowLog) << "Criando pixmap com tamanho:" << size << "e tile index:" << tileIndex;
 
     if (!entity) {
         qCWarning(mainWindowCategory) << "Entidade nula passada para createEntityPixmap";
-        return pixmap;
-    }
-
-    if (entity->isInvisible()) {
-        pixmap.fill(Qt::transparent);
-        painter.setPen(QPen(Qt::red, 2));
-        painter.drawRect(pixmap.rect().adjusted(1, 1, -1, -1));
-        painter.setFont(QFont("Arial", 8));
-        QString text = entity->getName();
-        QRectF textRect = painter.boundingRect(pixmap.rect(), Qt::AlignCenter, text);
-        if (textRect.width() > pixmap.width() - 4) {
-            text = painter.fontMetrics().elidedText(text, Qt::ElideRight, pixmap.width() - 4);
-        }
-        painter.drawText(pixmap.rect(), Qt::AlignCenter, text);
-        return pixmap;
-    } else if (entity->hasOnlyCollision()) {
-        painter.setPen(QPen(Qt::blue, 2));
-        painter.drawRect(pixmap.rect().adjusted(1, 1, -1, -1));
-        painter.drawText(pixmap.rect(), Qt::AlignCenter, "Collision");
-        qCInfo(mainWindowCategory) << "Desenhando entidade apenas com colisão";
-    } else {
-        QPixmap fullPixmap = entity->getPixmap();
-        const QVector<QRectF>& spriteDefinitions = entity->getSpriteDefinitions();
-        
-        qCInfo(mainWindowCategory) << "Número de sprites:" << spriteDefinitions.size();
-        
-        if (tileIndex >= 0 && tileIndex < spriteDefinitions.size()) {
-            QRectF spriteRect = spriteDefinitions[tileIndex];
-            painter.drawPixmap(pixmap.rect(), fullPixmap, spriteRect);
-            qCInfo(mainWindowCategory) << "Desenhando sprite" << tileIndex << "na posição" << spriteRect;
-        } else {
-            qCWarning(mainWindowCategory) << "Índice de tile inválido:" << tileIndex << ". Usando o primeiro sprite.";
-            if (!spriteDefinitions.isEmpty()) {
-                QRectF spriteRect = spriteDefinitions[0];
-                painter.drawPixmap(pixmap.rect(), fullPixmap, spriteRect);
-            }
-        }
     }
 
-    return pixmap;
+    // Pixmaps idênticos são compartilhados pelo cache em vez de redesenhados a cada colocação
+    return m_tileCache->tilePixmap(entity, tileIndex, size.toSize());
 }
 
 void MainWindow::cleanupResources()
 {
-    // Remover itens órfãos da cena
+    // Remover itens órfãos da cena (as colocações ficam todas na camada de tiles)
     QList<QGraphicsItem*> orphanItems = m_scene->items();
     for (QGraphicsItem* item : orphanItems) {
-        if (!m_entityPlacements.contains(static_cast<QGraphicsPixmapItem*>(item))) {
-            m_scene->removeItem(item);
-            delete item;
-        }
-    }
-
-    // Limpar o mapa de entidades
-    for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end();) {
-        if (!m_scene->items().contains(it.key())) {
-            it = m_entityPlacements.erase(it);
-        } else {
-            ++it;
+        if (item == m_tileLayer || item == m_previewItem) {
+            continue;
         }
+        m_scene->removeItem(item);
+        delete item;
     }
 
     qCInfo(mainWindowCategory) << "Recursos não utilizados foram limpos";
@@ -1602,21 +1572,10 @@ void MainWindow::cleanupResources()
 
 void MainWindow::removeSelectedEntities()
 {
-    QList<QGraphicsItem*> selectedItems = m_scene->selectedItems();
-    for (QGraphicsItem* item : selectedItems) {
-        QGraphicsPixmapItem* pixmapItem = dynamic_cast<QGraphicsPixmapItem*>(item);
-        if (pixmapItem) {
-            Action action;
-            action.type = Action::REMOVE;
-            action.entity = getEntityForPixmapItem(pixmapItem);
-            action.tileIndex = getTileIndexForPixmapItem(pixmapItem);
-            action.oldPos = pixmapItem->pos();
-            addAction(action);
-
-            m_scene->removeItem(pixmapItem);
-            m_entityPlacements.remove(pixmapItem);
-        }
-    }
+    // Apagar a seleção é um passo só no histórico
+    m_sceneModel->removePlacements(m_sceneModel->placements().selectedHandles());
+    m_currentSelectedPlacement = PlacementStore::InvalidHandle;
+    updatePropertiesPanel();
     updateGrid();
 }
 
@@ -1648,14 +1607,13 @@ void MainWindow::mouseMoveEvent(QMouseEvent *event)
 
 void MainWindow::updateEntityPositions()
 {
-    for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end(); ++it) {
-        QGraphicsItem* item = it.key();
-        const EntityPlacement& placement = it.value();
+    for (int handle : m_sceneModel->placements().handles()) {
+        const EntityPlacement& placement = m_sceneModel->placements().at(handle);
         QSizeF tileSize = placement.entity->getCurrentSize();
-        QPointF currentPos = item->pos();
+        QPointF currentPos = placement.pos();
         qreal gridX = qRound(currentPos.x() / tileSize.width()) * tileSize.width();
         qreal gridY = qRound(currentPos.y() / tileSize.height()) * tileSize.height();
-        item->setPos(gridX, gridY);
+        m_sceneModel->movePlacement(handle, QPointF(gridX, gridY), false);
     }
 }
 
@@ -1668,80 +1626,24 @@ void MainWindow::handleException(const QString &context, const std::exception &e
 
 bool MainWindow::undo()
 {
-    if (undoStack.isEmpty()) {
+    COMMAND_LATENCY("undo");
+    if (!m_sceneModel->history().canUndo()) {
         qCInfo(mainWindowCategory) << "Pilha de undo está vazia";
         return false;
     }
 
-    Entity* originalSelectedEntity = m_selectedEntity;
-    int originalSelectedTileIndex = m_selectedTileIndex;
     bool actionPerformed = false;
 
     try {
         preserveCurrentPreview();
-        Action action = undoStack.pop();
-        
-        if (!action.entity) {
-            qCWarning(mainWindowCategory) << "Ação inválida encontrada na pilha de undo";
-            return false;
-        }
-
-        switch (action.type) {
-            case Action::ADD:
-                {
-                    for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end(); ++it) {
-                        if (it.key()->pos() == action.newPos && it.value().entity == action.entity) {
-                            QGraphicsItem* item = it.key();
-                            m_scene->removeItem(item);
-                            m_entityPlacements.erase(it);
-                            delete item;
-                            actionPerformed = true;
-                            qCInfo(mainWindowCategory) << "Entidade removida da cena na posição:" << action.newPos;
-                            break;
-                        }
-                    }
-                }
-                break;
-            case Action::REMOVE:
-                {
-                    Entity* entityToRestore = m_entityManager->getEntityByName(action.entityName);
-                    if (entityToRestore) {
-                        m_selectedEntity = entityToRestore;
-                        m_selectedTileIndex = action.tileIndex;
-                        QGraphicsItem* newItem = placeEntityInScene(action.oldPos, false, entityToRestore, action.tileIndex, false);
-                        if (newItem) {
-                            actionPerformed = true;
-                            qCInfo(mainWindowCategory) << "Entidade restaurada na cena:" << action.entityName
-                                                    << "na posição:" << action.oldPos
-                                                    << "com tile index:" << action.tileIndex;
-                        }
-                    }
-                }
-                break;
-            case Action::MOVE:
-                {
-                    for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end(); ++it) {
-                        if (it.key()->pos() == action.newPos && it.value().entity == action.entity) {
-                            it.key()->setPos(action.oldPos);
-                            actionPerformed = true;
-                            qCInfo(mainWindowCategory) << "Entidade movida de volta para a posição:" << action.oldPos;
-                            break;
-                        }
-                    }
-                }
-                break;
-        }
-
-        m_selectedEntity = originalSelectedEntity;
-        m_selectedTileIndex = originalSelectedTileIndex;
+        actionPerformed = m_sceneModel->undo();
 
-        redoStack.push(action);
         if (actionPerformed) {
             updateGrid();
             update();
-            qCInfo(mainWindowCategory) << "Undo realizado com sucesso para ação do tipo:" << action.type 
-                                       << ". Tamanho da pilha de undo:" << undoStack.size()
-                                       << ". Tamanho da pilha de redo:" << redoStack.size();
+            qCInfo(mainWindowCategory) << "Undo realizado com sucesso"
+                                       << ". Tamanho da pilha de undo:" << m_sceneModel->history().undoCount()
+                                       << ". Tamanho da pilha de redo:" << m_sceneModel->history().redoCount();
         }
 
     } catch (const std::exception& e) {
@@ -1756,84 +1658,24 @@ bool MainWindow::undo()
 
 bool MainWindow::redo()
 {
-    if (redoStack.isEmpty()) {
+    COMMAND_LATENCY("redo");
+    if (!m_sceneModel->history().canRedo()) {
         qCInfo(mainWindowCategory) << "Pilha de redo está vazia";
         return false;
     }
 
-    Entity* originalSelectedEntity = m_selectedEntity;
-    int originalSelectedTileIndex = m_selectedTileIndex;
     bool actionPerformed = false;
 
     try {
         preserveCurrentPreview();
-        Action action = redoStack.pop();
-        
-        if (!action.entity) {
-            qCWarning(mainWindowCategory) << "Ação inválida encontrada na pilha de redo";
-            return false;
-        }
-        switch (action.type) {
-            case Action::ADD:
-                {
-                    m_selectedEntity = action.entity;
-                    m_selectedTileIndex = action.tileIndex;
-                    QGraphicsItem* newItem = placeEntityInScene(action.newPos, false, action.entity, action.tileIndex, false);
-                    if (newItem) {
-                        QGraphicsPixmapItem* pixmapItem = dynamic_cast<QGraphicsPixmapItem*>(newItem);
-                        if (pixmapItem) {
-                            // Use pixmapItem aqui se necessário
-                        }
-                        qCInfo(mainWindowCategory) << "Entidade restaurada na cena:" << action.entityName
-                                                << "na posição:" << action.newPos
-                                                << "com tile index:" << action.tileIndex;
-                    }
-                }
-                break;
-            case Action::REMOVE:
-                {
-                    for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end(); ++it) {
-                        if (it.key()->pos() == action.oldPos && it.value().entity->getName() == action.entityName) {
-                            QGraphicsItem* item = it.key();
-                            m_scene->removeItem(item);
-                            m_entityPlacements.erase(it);
-                            delete item;
-                            actionPerformed = true;
-                            qCInfo(mainWindowCategory) << "Entidade removida da cena:" << action.entityName
-                                                       << "na posição:" << action.oldPos;
-                            break;
-                        }
-                    }
-                }
-                break;
-            case Action::MOVE:
-            {
-                for (auto it = m_entityPlacements.begin(); it != m_entityPlacements.end(); ++it) {
-                    if (it.key()->pos() == action.oldPos && it.value().entity == action.entity) {
-                        QGraphicsItem* item = it.key();
-                        item->setPos(action.newPos);
-                        actionPerformed = true;
-                        qCInfo(mainWindowCategory) << "Entidade movida na cena:" << action.entity->getName()
-                                                << "da posição:" << action.oldPos
-                                                << "para:" << action.newPos;
-                        break;
-                    }
-                }
-            }
-            break;
-        }
+        actionPerformed = m_sceneModel->redo();
 
-        // Restaure a entidade e tile index originais
-        m_selectedEntity = originalSelectedEntity;
-        m_selectedTileIndex = originalSelectedTileIndex;
-        
-        undoStack.push(action);  // Sempre adicione a ação à pilha de undo        
         if (actionPerformed) {
             updateGrid();
             update();
-            qCInfo(mainWindowCategory) << "Redo realizado com sucesso para ação do tipo:" << action.type 
-                                       << ". Tamanho da pilha de undo:" << undoStack.size()
-                                       << ". Tamanho da pilha de redo:" << redoStack.size();
+            qCInfo(mainWindowCategory) << "Redo realizado com sucesso"
+                                       << ". Tamanho da pilha de undo:" << m_sceneModel->history().undoCount()
+                                       << ". Tamanho da pilha de redo:" << m_sceneModel->history().redoCount();
         }
 
     } catch (const std::exception& e) {
@@ -1850,205 +1692,84 @@ void MainWindow::preserveCurrentPreview()
 {
     m_preservedPreviewEntity = m_previewEntity;
     m_preservedPreviewTileIndex = m_previewTileIndex;
-    if (QGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<QGraphicsPixmapItem*>(m_previewItem)) {
-        m_preservedPreviewPixmap = pixmapItem->pixmap();
-    } else {
-        m_preservedPreviewPixmap = QPixmap();
-    }
 }
 
 void MainWindow::restorePreservedPreview()
 {
     if (m_preservedPreviewEntity) {
-        m_previewEntity = m_preservedPreviewEntity;
-        m_previewTileIndex = m_preservedPreviewTileIndex;
-        if (QGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<QGraphicsPixmapItem*>(m_previewItem)) {
-            if (!m_preservedPreviewPixmap.isNull()) {
-                pixmapItem->setPixmap(m_preservedPreviewPixmap);
-            }
-        } else if (QGraphicsRectItem* rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(m_previewItem)) {
-            // Restaurar as propriedades do retângulo, se necessário
-            rectItem->setPen(QPen(Qt::red, 2, Qt::DashLine));
-            rectItem->setBrush(Qt::transparent);
-        }
-    }
-}
-
-void MainWindow::addAction(const Action& action)
-{
-    if (action.type == Action::ADD || action.type == Action::REMOVE || action.type == Action::MOVE) {
-        if (action.type == Action::MOVE && action.oldPos == action.newPos) {
-            qCDebug(mainWindowCategory) << "Ignorando ação de movimento sem mudança de posição";
-            return;
-        }
-        undoStack.push(action);
-        redoStack.clear();
-        qCInfo(mainWindowCategory) << "Ação adicionada à pilha de undo. Tipo:" << action.type 
-                                   << "Posição:" << (action.type == Action::ADD ? action.newPos : action.oldPos)
-                                   << "Entidade:" << (action.entity ? action.entity->getName() : "Nenhuma")
-                                   << "Tamanho da pilha de undo:" << undoStack.size();
-        qCDebug(mainWindowCategory) << "Ação adicionada em" << QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    } else {
-        qCWarning(mainWindowCategory) << "Tentativa de adicionar ação inválida ignorada. Tipo:" << action.type;
+        // Mesma chave: o pixmap do item continua o mesmo e nada é redesenhado
+        refreshPreviewPixmap(m_preservedPreviewEntity, m_preservedPreviewTileIndex, m_previewPixmapErase);
     }
 }
 
 void MainWindow::checkStackConsistency()
 {
-    qDebug() << "Verificando consistência das pilhas:";
-    qDebug() << "  Tamanho da pilha de undo:" << undoStack.size();
-    qDebug() << "  Tamanho da pilha de redo:" << redoStack.size();
-    
-    // Verifique se todos os itens nas pilhas são válidos
-    for (const Action& action : undoStack) {
-        if (!action.entity) {
-            qWarning() << "Ação inválida encontrada na pilha de undo";
-        }
-    }
-    for (const Action& action : redoStack) {
-        if (!action.entity) {
-            qWarning() << "Ação inválida encontrada na pilha de redo";
-        }
-    }
+    SCENE_LOG_DEBUG(mainWindowLog) << "Verificando consistência das pilhas:";
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Tamanho da pilha de undo:" << m_sceneModel->history().undoCount();
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Tamanho da pilha de redo:" << m_sceneModel->history().redoCount();
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Memória do histórico:" << m_sceneModel->history().memoryBytes() << "de" << m_sceneModel->history().memoryLimitBytes() << "bytes";
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Passos descartados pelo limite:" << m_sceneModel->history().droppedStepCount();
 }
 
 void MainWindow::checkConsistency()
 {
-    qDebug() << "Verificando consistência:";
-    qDebug() << "  Itens na cena:" << m_scene->items().count();
-    qDebug() << "  Entidades no mapa:" << m_entityPlacements.size();
-    qDebug() << "  Tamanho da pilha de undo:" << undoStack.size();
-    qDebug() << "  Tamanho da pilha de redo:" << redoStack.size();
-}
-
-void MainWindow::saveCrashReport()
-{
-    QFile file("crash_report.txt");
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << "Crash Report\n";
-        out << "Timestamp: " << QDateTime::currentDateTime().toString() << "\n";
-        out << "Número de entidades: " << m_entityPlacements.size() << "\n";
-        out << "Estado do Shift: " << (m_shiftPressed ? "Pressionado" : "Liberado") << "\n";
-        // Adicione mais informações relevantes
-    }
+    SCENE_LOG_DEBUG(mainWindowLog) << "Verificando consistência:";
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Itens na cena:" << m_scene->items().count();
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Entidades no mapa:" << m_sceneModel->placements().count();
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Tamanho da pilha de undo:" << m_sceneModel->history().undoCount();
+    SCENE_LOG_DEBUG(mainWindowLog) << "  Tamanho da pilha de redo:" << m_sceneModel->history().redoCount();
 }
 
 void MainWindow::saveScene()
 {
-    if (m_currentScenePath.isEmpty()) {
+    QString scenePath = m_sceneModel->scenePath();
+    if (scenePath.isEmpty()) {
         QString fileName = QFileDialog::getSaveFileName(this, tr("Salvar Cena"), 
                                                         m_projectPath, 
-                                                        tr("Arquivos de Cena (*.esc)"));
+                                                        tr("Arquivos de Cena (*.esc);;Arquivos de Cena Binários (*.escb)"));
         if (fileName.isEmpty())
             return;
         
-        if (!fileName.endsWith(".esc")) {
+        if (!fileName.endsWith(".esc") && !fileName.endsWith(".escb")) {
             fileName += ".esc";
         }
         
-        m_currentScenePath = fileName;
+        scenePath = fileName;
     }
 
-    QFile file(m_currentScenePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, tr("Erro"), tr("Não foi possível abrir o arquivo para escrita."));
+    COMMAND_LATENCY("saveScene");
+    SceneModel::FileStats stats;
+    if (!m_sceneModel->saveScene(scenePath, &stats)) {
+        QMessageBox::warning(this, tr("Erro"), m_sceneModel->errorString());
         return;
     }
 
-    QXmlStreamWriter xml(&file);
-    xml.setAutoFormatting(true);
-    xml.writeStartDocument();
-
-    xml.writeStartElement("Ethanon");
-
-    // Escrever propriedades da cena
-    xml.writeStartElement("SceneProperties");
-    xml.writeAttribute("lightIntensity", "2");
-    xml.writeAttribute("parallaxIntensity", "0");
-
-    xml.writeStartElement("Ambient");
-    xml.writeAttribute("r", "1");
-    xml.writeAttribute("g", "1");
-    xml.writeAttribute("b", "1");
-    xml.writeEndElement(); // Ambient
-
-    xml.writeStartElement("ZAxisDirection");
-    xml.writeAttribute("x", "0");
-    xml.writeAttribute("y", "-1");
-    xml.writeEndElement(); // ZAxisDirection
-
-    xml.writeEndElement(); // SceneProperties
-
-    // Escrever entidades na cena
-    xml.writeStartElement("EntitiesInScene");
-
-    int entityId = 1;
-    for (const auto& item : m_scene->items()) {
-        QGraphicsPixmapItem* pixmapItem = dynamic_cast<QGraphicsPixmapItem*>(item);
-        if (pixmapItem) {
-            auto it = m_entityPlacements.find(pixmapItem);
-            if (it != m_entityPlacements.end()) {
-                Entity* entity = it->entity;
-                int tileIndex = it->tileIndex;
-
-                xml.writeStartElement("Entity");
-                xml.writeAttribute("id", QString::number(entityId++));
-                xml.writeAttribute("spriteFrame", QString::number(tileIndex));
-
-                xml.writeTextElement("EntityName", entity->getName() + ".ent");
-
-                // Calcular a posição corrigida
-                QSizeF entitySize = entity->getCurrentSize();
-                if (entitySize.isEmpty()) {
-                    entitySize = entity->getCollisionSize();
-                    if (entitySize.isEmpty()) {
-                        entitySize = QSizeF(32, 32);
-                    }
-                }
-                QPointF correctedPos = pixmapItem->pos() + QPointF(entitySize.width() / 2, entitySize.height() / 2);
-
-                xml.writeStartElement("Position");
-                xml.writeAttribute("x", QString::number(static_cast<int>(correctedPos.x())));
-                xml.writeAttribute("y", QString::number(static_cast<int>(correctedPos.y())));
-                xml.writeAttribute("z", "0");
-                xml.writeAttribute("angle", "0");
-                xml.writeEndElement(); // Position
-
-                xml.writeStartElement("Entity");
-                xml.writeTextElement("FileName", entity->getName() + ".ent");
-                xml.writeEndElement(); // Entity
-
-                xml.writeEndElement(); // Entity
-            }
-        }
+    if (stats.skipped) {
+        statusBar()->showMessage(tr("Nenhuma alteração para salvar: %1").arg(scenePath), 3000);
+        qCInfo(mainWindowCategory) << "Save ignorado, cena sem alterações:" << scenePath;
+        return;
     }
 
-    xml.writeEndElement(); // EntitiesInScene
-
-    xml.writeEndElement(); // Ethanon
-
-    xml.writeEndDocument();
-
-    file.close();
-
-    statusBar()->showMessage(tr("Cena salva com sucesso: %1").arg(m_currentScenePath), 3000);
-    qCInfo(mainWindowCategory) << "Cena salva em:" << m_currentScenePath;
+    statusBar()->showMessage(tr("Cena salva com sucesso: %1").arg(scenePath), 3000);
+    qCInfo(mainWindowCategory) << "Cena salva em:" << scenePath << "-"
+                               << stats.entityCount << "entidades formatadas,"
+                               << stats.reusedSections << "de" << stats.sectionCount << "chunks reaproveitados em"
+                               << stats.elapsedMs << "ms";
 }
 
 void MainWindow::saveSceneAs()
 {
     QString fileName = QFileDialog::getSaveFileName(this, tr("Save Scene As"), 
                                                     m_projectPath, 
-                                                    tr("Scene Files (*.esc)"));
+                                                    tr("Scene Files (*.esc);;Binary Scene Files (*.escb)"));
     if (fileName.isEmpty())
         return;
     
-    if (!fileName.endsWith(".esc")) {
+    if (!fileName.endsWith(".esc") && !fileName.endsWith(".escb")) {
         fileName += ".esc";
     }
     
-    m_currentScenePath = fileName;
+    m_sceneModel->setScenePath(fileName);
     saveScene(); 
 }
 
@@ -2058,93 +1779,46 @@ void MainWindow::exportScene()
     if (fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, tr("Erro"), tr("Não foi possível abrir o arquivo para escrita."));
+    SceneModel::FileStats stats;
+    if (!m_sceneModel->exportScene(fileName, &stats)) {
+        QMessageBox::warning(this, tr("Erro"), m_sceneModel->errorString());
         return;
     }
+    qCInfo(mainWindowCategory) << "Cena exportada:" << stats.entityCount << "entidades em"
+                               << stats.elapsedMs << "ms";
 
-    QXmlStreamWriter xml(&file);
-    xml.setAutoFormatting(true);
-    xml.writeStartDocument();
-
-    xml.writeStartElement("Ethanon");
-
-    // Escrever propriedades da cena
-    xml.writeStartElement("SceneProperties");
-    xml.writeAttribute("lightIntensity", "2");
-    xml.writeAttribute("parallaxIntensity", "0");
-
-    xml.writeStartElement("Ambient");
-    xml.writeAttribute("r", "1");
-    xml.writeAttribute("g", "1");
-    xml.writeAttribute("b", "1");
-    xml.writeEndElement(); // Ambient
-
-    xml.writeStartElement("ZAxisDirection");
-    xml.writeAttribute("x", "0");
-    xml.writeAttribute("y", "-1");
-    xml.writeEndElement(); // ZAxisDirection
-
-    xml.writeEndElement(); // SceneProperties
-
-    // Escrever entidades na cena
-    xml.writeStartElement("EntitiesInScene");
-
-    int entityId = 1;
-    for (const auto& item : m_scene->items()) {
-        QGraphicsPixmapItem* pixmapItem = dynamic_cast<QGraphicsPixmapItem*>(item);
-        if (pixmapItem) {
-            auto it = m_entityPlacements.find(pixmapItem);
-            if (it != m_entityPlacements.end()) {
-                Entity* entity = it->entity;
-                int tileIndex = it->tileIndex;
-
-                xml.writeStartElement("Entity");
-                xml.writeAttribute("id", QString::number(entityId++));
-                xml.writeAttribute("spriteFrame", QString::number(tileIndex));
-
-                xml.writeTextElement("EntityName", entity->getName() + ".ent");
-
-                // Calcular a posição corrigida
-                QSizeF entitySize = entity->getCurrentSize();
-                if (entitySize.isEmpty()) {
-                    entitySize = entity->getCollisionSize();
-                    if (entitySize.isEmpty()) {
-                        entitySize = QSizeF(32, 32);
-                    }
-                }
-                QPointF correctedPos = pixmapItem->pos() + QPointF(entitySize.width() / 2, entitySize.height() / 2);
-
-                xml.writeStartElement("Position");
-                xml.writeAttribute("x", QString::number(static_cast<int>(correctedPos.x())));
-                xml.writeAttribute("y", QString::number(static_cast<int>(correctedPos.y())));
-                xml.writeAttribute("z", "0");
-                xml.writeAttribute("angle", "0");
-                xml.writeEndElement(); // Position
+    QMessageBox::information(this, tr("Sucesso"), tr("Cena exportada com sucesso."));
+}
 
-                xml.writeStartElement("Entity");
-                xml.writeTextElement("FileName", entity->getName() + ".ent");
-                xml.writeEndElement(); // Entity
+void MainWindow::convertScene()
+{
+    QString sourceName = QFileDialog::getOpenFileName(this, tr("Converter Cena"), m_projectPath,
+                                                      tr("Arquivos de Cena (*.esc *.escb)"));
+    if (sourceName.isEmpty())
+        return;
 
-                xml.writeEndElement(); // Entity
+    // O destino é sempre o outro formato
+    const bool toBinary = !sourceName.endsWith(".escb");
+    QFileInfo sourceInfo(sourceName);
+    QString suggested = sourceInfo.path() + "/" + sourceInfo.completeBaseName() + (toBinary ? ".escb" : ".esc");
+    QString targetName = QFileDialog::getSaveFileName(this, tr("Converter Cena"), suggested,
+                                                      toBinary ? tr("Arquivos de Cena Binários (*.escb)")
+                                                               : tr("Arquivos de Cena (*.esc)"));
+    if (targetName.isEmpty())
+        return;
 
-                qCInfo(mainWindowCategory) << "Exportando entidade:" << entity->getName()
-                                           << "na posição:" << correctedPos
-                                           << "tamanho:" << entitySize;
-            }
-        }
+    QElapsedTimer convertTimer;
+    convertTimer.start();
+    const bool ok = toBinary ? BinarySceneFile::convertEscToEscb(sourceName, targetName)
+                             : BinarySceneFile::convertEscbToEsc(sourceName, targetName);
+    if (!ok) {
+        QMessageBox::warning(this, tr("Erro"), tr("Não foi possível converter a cena."));
+        return;
     }
 
-    xml.writeEndElement(); // EntitiesInScene
-
-    xml.writeEndElement(); // Ethanon
-
-    xml.writeEndDocument();
-
-    file.close();
-
-    QMessageBox::information(this, tr("Sucesso"), tr("Cena exportada com sucesso."));
+    qCInfo(mainWindowCategory) << "Cena convertida:" << sourceName << "->" << targetName
+                               << "em" << convertTimer.elapsed() << "ms";
+    statusBar()->showMessage(tr("Cena convertida: %1").arg(targetName), 3000);
 }
 
 void MainWindow::handleTileItemClick(QLabel* spritesheetLabel, const QPoint& pos)
@@ -2184,8 +1858,11 @@ void MainWindow::handleTileItemClick(QLabel* spritesheetLabel, const QPoint& pos
 
 void MainWindow::updatePropertiesPanel()
 {
-    if (m_currentTool == SelectTool && m_currentSelectedItem) {
-        QPointF pos = m_currentSelectedItem->pos();
+    if (m_currentTool == SelectTool && m_sceneModel->placements().isValid(m_currentSelectedPlacement)) {
+        QPointF pos = m_sceneModel->placements().at(m_currentSelectedPlacement).pos();
+        // Sem bloquear, o primeiro setValue moveria a entidade com o Y antigo
+        const QSignalBlocker blockX(m_posXSpinBox);
+        const QSignalBlocker blockY(m_posYSpinBox);
         m_posXSpinBox->setValue(pos.x());
         m_posYSpinBox->setValue(pos.y());
         m_propertiesDock->setEnabled(true);
@@ -2196,20 +1873,133 @@ void MainWindow::updatePropertiesPanel()
     }
 }
 
-Entity* MainWindow::getEntityForPixmapItem(QGraphicsPixmapItem* item)
+void MainWindow::pickEntityAt(const QPointF &scenePos)
+{
+    // Conta-gotas: a colocação sob o cursor, ou a mais próxima dentro de meia célula da grade
+    int handle = m_sceneModel->placements().topmostAt(scenePos);
+    if (handle == PlacementStore::InvalidHandle) {
+        handle = m_sceneModel->placements().nearest(scenePos, m_gridSize / 2.0);
+    }
+    if (handle == PlacementStore::InvalidHandle) {
+        qCInfo(mainWindowCategory) << "Conta-gotas: nenhuma entidade perto de" << scenePos;
+        return;
+    }
+
+    const EntityPlacement &placement = m_sceneModel->placements().at(handle);
+    const QString entityName = placement.entity->getName();
+    const int tileIndex = placement.tileIndex;
+
+    QList<QListWidgetItem*> entityItems = m_entityList->findItems(entityName, Qt::MatchExactly);
+    if (entityItems.isEmpty()) {
+        qCWarning(mainWindowCategory) << "Conta-gotas: entidade fora da lista:" << entityName;
+        return;
+    }
+    m_entityList->setCurrentItem(entityItems.first());
+    onEntityItemClicked(entityItems.first());
+
+    for (int row = 0; row < m_tileList->count(); ++row) {
+        QListWidgetItem *tileItem = m_tileList->item(row);
+        if (tileItem->data(Qt::UserRole).toInt() == tileIndex) {
+            m_tileList->setCurrentRow(row);
+            onTileItemClicked(tileItem);
+            break;
+        }
+    }
+    qCInfo(mainWindowCategory) << "Conta-gotas:" << entityName << "tile" << tileIndex;
+}
+
+void MainWindow::onPlacementsMoved(const QVector<int> &handles, const QVector<QPointF> &oldPositions)
+{
+    m_sceneModel->recordMoves(handles, oldPositions);
+    updatePropertiesPanel();
+    qCDebug(mainWindowCategory) << "Movimento finalizado:" << handles.size() << "entidades";
+}
+
+void MainWindow::onPlacementSelectionChanged()
+{
+    const QVector<int> selected = m_sceneModel->placements().selectedHandles();
+    m_currentSelectedPlacement = selected.size() == 1 ? selected.first() : PlacementStore::InvalidHandle;
+    updatePropertiesPanel();
+}
+
+void MainWindow::onRubberBandChanged(QRect rubberBandRect, QPointF fromScenePoint, QPointF toScenePoint)
+{
+    // Retângulo nulo = fim do arraste; a seleção já está feita
+    if (rubberBandRect.isNull()) {
+        return;
+    }
+    m_tileLayer->selectInRect(QRectF(fromScenePoint, toScenePoint).normalized());
+}
+
+void MainWindow::updateUndoStatus()
 {
-    auto it = m_entityPlacements.find(item);
-    if (it != m_entityPlacements.end()) {
-        return it->entity;
+    if (!m_undoStatusLabel) {
+        return;
     }
-    return nullptr;
+    m_undoStatusLabel->setText(QString("Undo: %1 passos, %2 de %3 KiB")
+                                   .arg(m_sceneModel->history().undoCount())
+                                   .arg(m_sceneModel->history().memoryBytes() / 1024)
+                                   .arg(m_sceneModel->history().memoryLimitBytes() / 1024));
 }
 
-int MainWindow::getTileIndexForPixmapItem(QGraphicsPixmapItem* item)
+void MainWindow::openProject(const QString &dir)
 {
-    auto it = m_entityPlacements.find(item);
-    if (it != m_entityPlacements.end()) {
-        return it->tileIndex;
+    m_projectPath = dir;
+    m_sceneModel->setProjectPath(m_projectPath);
+    m_fileSystemModel->setRootPath(m_projectPath);
+    m_projectExplorer->setRootIndex(m_fileSystemModel->index(m_projectPath));
+    statusBar()->showMessage("Project opened: " + m_projectPath);
+    loadEntities();
+}
+
+void MainWindow::recoverFromJournal()
+{
+    const QString journalPath = EditJournal::abandonedJournalPath();
+    EditJournal::Contents contents;
+    if (journalPath.isEmpty() || !EditJournal::read(journalPath, contents) || contents.entries.isEmpty()) {
+        m_sceneModel->restartJournal(QString());
+        return;
+    }
+
+    qCWarning(mainWindowCategory) << "Journal de uma sessão não encerrada:" << journalPath << "-"
+                                  << contents.entries.size() << "edições em" << contents.stepCount << "passos"
+                                  << (contents.truncated ? "(final cortado)" : "");
+    const QString sceneName = contents.scenePath.isEmpty() ? tr("cena sem nome") : contents.scenePath;
+    const QMessageBox::StandardButton answer = QMessageBox::question(
+        this, tr("Recuperar edições"),
+        tr("O editor não foi fechado corretamente.\n\n"
+           "Recuperar %1 edições (%2 passos) feitas em %3 depois do último save?")
+            .arg(contents.entries.size()).arg(contents.stepCount).arg(sceneName),
+        QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+    if (answer != QMessageBox::Yes) {
+        m_sceneModel->restartJournal(QString());
+        return;
     }
-    return -1;
+
+    // Projeto e cena de base primeiro; os dois recomeçam o journal, que já está em memória
+    if (!contents.projectPath.isEmpty() && QDir(contents.projectPath).exists()) {
+        openProject(contents.projectPath);
+    }
+    if (!contents.scenePath.isEmpty() && QFileInfo::exists(contents.scenePath)) {
+        openScene(contents.scenePath);
+    } else {
+        m_sceneModel->restartJournal(QString());
+    }
+    replayJournal(contents);
+}
+
+void MainWindow::replayJournal(const EditJournal::Contents &contents)
+{
+    QElapsedTimer replayTimer;
+    replayTimer.start();
+
+    int skipped = 0;
+    const int applied = m_sceneModel->replayJournal(contents, &skipped);
+    m_currentSelectedPlacement = PlacementStore::InvalidHandle;
+    updateGrid();
+
+    const qint64 elapsedMs = replayTimer.elapsed();
+    qCInfo(mainWindowCategory) << "Journal reaplicado:" << applied << "edições em" << elapsedMs << "ms,"
+                               << skipped << "ignoradas";
+    statusBar()->showMessage(tr("%1 edições recuperadas em %2 ms").arg(applied).arg(elapsedMs), 5000);
 }
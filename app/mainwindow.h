@@ -13,6 +13,13 @@
 #include <QDoubleSpinBox>
 #include "entitymanager.h"
 #include "entity.h"
+#include "tilepixmapcache.h"
+#include "scenemodel.h"
+
+class TileLayerItem;
+class SceneView;
+class DiagnosticsDock;
+class MemoryDock;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -33,18 +40,18 @@ public:
         MoveTool,
         BrushTool
     };
-    QGraphicsItem* placeEntityInScene(const QPointF &pos, bool addToUndoStack = true, Entity* entity = nullptr, int tileIndex = -1, bool updatePreview = true);
+    int placeEntityInScene(const QPointF &pos, bool addToUndoStack = true, Entity* entity = nullptr, int tileIndex = -1, bool updatePreview = true,
+                           quint64 placementId = PlacementStore::InvalidId);
 
 private:
-    Entity* getEntityForGraphicsItem(QGraphicsItem* item);
-    QGraphicsItem* m_currentSelectedItem;
+    int m_currentSelectedPlacement;
     void updatePropertiesPanel();
     void updateSelectedEntityPosition();
     QList<QGraphicsItem*> m_selectedItems;
     QDoubleSpinBox *m_posXSpinBox;
     QDoubleSpinBox *m_posYSpinBox;
-    QPixmap m_preservedPreviewPixmap;
     QPixmap createErasePreviewPixmap();
+    QPixmap createInvisiblePreviewPixmap(const QSizeF &size);
     Entity* m_preservedPreviewEntity;
     int m_preservedPreviewTileIndex;
     Entity* m_previewEntity;
@@ -56,8 +63,9 @@ private:
     QAction *redoAction;
     Ui::MainWindow *ui;
     QGraphicsScene *m_scene;
-    QGraphicsView *m_sceneView;
+    SceneView *m_sceneView;
     EntityManager *m_entityManager;
+    TilePixmapCache *m_tileCache;
     QTreeView *m_projectExplorer;
     QFileSystemModel *m_fileSystemModel;
     QListWidget *m_entityList;
@@ -65,48 +73,39 @@ private:
     QDockWidget *m_propertiesDock;
     QLabel *m_spritesheetLabel;
     QString m_projectPath;
-    QString m_currentScenePath;
     Entity *m_selectedEntity;
     int m_selectedTileIndex;
-    QGraphicsItem* m_previewItem;
+    // Item único do preview do pincel: criado com a cena e só escondido, nunca recriado
+    QGraphicsPixmapItem* m_previewItem;
+    // Chave do pixmap mostrado pelo preview; o pixmap só é refeito quando ela muda
+    Entity* m_previewPixmapEntity;
+    int m_previewPixmapTileIndex;
+    bool m_previewPixmapErase;
+    // Movimentos do mouse só guardam a posição; o setPos sai uma vez por quadro
+    QTimer* m_previewPositionTimer;
+    QPointF m_pendingPreviewPos;
     bool m_shiftPressed;
     int m_gridSize;
     Tool m_currentTool;
     bool m_ctrlPressed;
 
-    struct EntityPlacement {
-        Entity *entity;
-        int tileIndex;
-        QGraphicsItem *item;
-    };
-
-    void logToFile(const QString& message);
     void cleanupResources();
     void clearPreviewIfNotBrushTool();
 
     // Adicione esta variável de membro
     int updateCount;
 
-    QMap<QGraphicsItem*, EntityPlacement> m_entityPlacements;
-
-    // Estrutura para armazenar ações
-    struct Action {
-        enum Type { ADD, REMOVE, MOVE };
-        Type type;
-        Entity* entity;
-        int m_previewTileIndex;
-        int tileIndex;
-        QPointF oldPos;
-        QPointF newPos;
-        QString entityName;  // Adicione isso
-    };
+    // Colocações, histórico, journal e save da cena; a janela é só a view
+    SceneModel *m_sceneModel;
+    TileLayerItem *m_tileLayer;
 
-    QStack<Action> undoStack;
-    QStack<Action> redoStack;
-    QGraphicsItem* m_movingItem;
+    // Journal do modelo gravado com fsync a cada m_journalTimer
+    QTimer *m_journalTimer;
+    QLabel *m_undoStatusLabel;
+    bool m_brushStrokeOpen;  // Passo do histórico aberto entre o press e o release do pincel
     QGraphicsPixmapItem *m_entityPreview;
-    QPointF m_oldPosition;
-    QVector<QGraphicsLineItem*> m_gridLines;
+    DiagnosticsDock *m_diagnosticsDock;
+    MemoryDock *m_memoryDock;
     QPointF m_lastCursorPosition;
 
     void updateCursor(const QPointF& scenePos);
@@ -117,9 +116,13 @@ private:
     void setupTileList();
     void createActions();
     void loadEntities();
+    // Recarregar as entidades esvazia a cena: pergunta antes de perder edições não salvas
+    bool confirmEntityReload();
     void updateGrid();
     void updateEntityPreview();
     void updatePreviewPosition(const QPointF& scenePos);
+    void refreshPreviewPixmap(Entity* entity, int tileIndex, bool erase);
+    void applyPendingPreviewPosition();
     void clearPreview();
     void clearSelection();
     void updateTileList();
@@ -135,22 +138,21 @@ private:
     void paintWithBrush(const QPointF &pos);
     void eraseEntity();
     void checkConsistency();
-    void saveCrashReport();
+    void replayJournal(const EditJournal::Contents &contents);
+    void openProject(const QString &dir);
+    void openScene(const QString &fileName);
     void recoverSceneState();
     void enterEvent(QEvent *event);
     void checkStackConsistency();
     void updatePaintingMode();
     void preserveCurrentPreview();
     void restorePreservedPreview();
-    void placeImportedEntityInScene(const QPointF &pos, Entity* entity, int tileIndex);
-    
-    Entity* getEntityForPixmapItem(QGraphicsPixmapItem* item);
-    int getTileIndexForPixmapItem(QGraphicsPixmapItem* item);
+    void pickEntityAt(const QPointF &scenePos);
 
     bool undo();
     bool redo();
     bool m_paintingMode = false;
-    void addAction(const Action& action);
+    void updateUndoStatus();
     QPixmap createEntityPixmap(const QSizeF &size, Entity* entity = nullptr, int tileIndex = -1);
 
 protected:
@@ -175,12 +177,22 @@ private slots:
     void exportScene();
     void saveScene();
     void saveSceneAs();
+    void convertScene();
+    void recoverFromJournal();
     void onSceneViewMousePress(QMouseEvent *event);
     void onSceneViewMouseMove(QMouseEvent *event);
     void updateShiftState(bool pressed);
     void removeSelectedEntities();
     void activateSelectTool();
     void activateBrushTool();
+    void onPlacementsMoved(const QVector<int> &handles, const QVector<QPointF> &oldPositions);
+    void onPlacementSelectionChanged();
+    void onPlacementsChanged(const QRectF &area);
+    void onPlacementRemoved(int handle);
+    void onRubberBandChanged(QRect rubberBandRect, QPointF fromScenePoint, QPointF toScenePoint);
+    void setTraceRecording(bool enabled);
+    void setInputLatencyProbe(bool enabled);
+    void dumpPerformanceStats();
 };
 
 class CustomGraphicsView : public QGraphicsView
@@ -0,0 +1,228 @@
+#include "memorydock.h"
+#include "entity.h"
+#include "scenemodel.h"
+#include "spritesheetcache.h"
+#include "tilepixmapcache.h"
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMap>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+
+struct Consumer
+{
+    QString name;
+    qint64 bytes;
+    QString detail;
+};
+
+struct EntityUsage
+{
+    const Entity *entity;
+    qint64 spritesheetBytes;
+    qint64 tileBytes;
+};
+
+QTableWidgetItem *numberItem(const QString &text)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString megabytes(qint64 bytes)
+{
+    return QString::number(bytes / (1024.0 * 1024.0), 'f', 1);
+}
+
+QString itemTypeName(const QGraphicsItem *item)
+{
+    switch (item->type()) {
+    case QGraphicsPixmapItem::Type:
+        return "Pixmap";
+    case QGraphicsLineItem::Type:
+        return "Linha";
+    case QGraphicsRectItem::Type:
+        return "Retângulo";
+    case QGraphicsSimpleTextItem::Type:
+    case QGraphicsTextItem::Type:
+        return "Texto";
+    default:
+        break;
+    }
+    if (const QGraphicsObject *object = item->toGraphicsObject()) {
+        return object->metaObject()->className();
+    }
+    return QString("Tipo %1").arg(item->type());
+}
+
+QTableWidget *createTable(const QStringList &headers)
+{
+    QTableWidget *table = new QTableWidget(0, headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->verticalHeader()->hide();
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    return table;
+}
+
+}
+
+MemoryDock::MemoryDock(QWidget *parent)
+    : QDockWidget("Memória", parent),
+      m_sceneModel(nullptr),
+      m_scene(nullptr),
+      m_tileCache(nullptr),
+      m_spritesheets(nullptr),
+      m_consumerTable(createTable({ "Consumidor", "MB", "Detalhe" })),
+      m_entityTable(createTable({ "Entidade", "Spritesheet (MB)", "Tiles (MB)", "Total (MB)" })),
+      m_refreshTimer(new QTimer(this))
+{
+    setObjectName("memoryDock");
+    setAllowedAreas(Qt::AllDockWidgetAreas);
+    m_entityTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_entityTable->horizontalHeader()->setStretchLastSection(false);
+
+    QWidget *container = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(container);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->addWidget(m_consumerTable);
+    layout->addWidget(new QLabel(QString("Entidades que mais ocupam (até %1)").arg(TopEntityCount)));
+    layout->addWidget(m_entityTable);
+    setWidget(container);
+
+    m_refreshTimer->setInterval(RefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &MemoryDock::refresh);
+    connect(this, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            refresh();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    });
+}
+
+void MemoryDock::setSources(SceneModel *sceneModel, const QGraphicsScene *scene,
+                            const TilePixmapCache *tileCache, const SpritesheetCache *spritesheets)
+{
+    m_sceneModel = sceneModel;
+    m_scene = scene;
+    m_tileCache = tileCache;
+    m_spritesheets = spritesheets;
+}
+
+void MemoryDock::refresh()
+{
+    refreshConsumers();
+    refreshEntities();
+}
+
+void MemoryDock::refreshConsumers()
+{
+    QVector<Consumer> consumers;
+    if (m_spritesheets) {
+        consumers.append({ "Spritesheets decodificados", m_spritesheets->decodedBytes(),
+                           QString("%1 entidades, orçamento de %2 MB, %3 descarregadas")
+                               .arg(m_spritesheets->decodedCount()).arg(megabytes(m_spritesheets->budgetBytes()))
+                               .arg(m_spritesheets->evictionCount()) });
+    }
+    if (m_tileCache) {
+        consumers.append({ "Cache de tiles", m_tileCache->bytes(),
+                           QString("%1 pixmaps, %2% acertos")
+                               .arg(m_tileCache->count()).arg(qRound(m_tileCache->hitRate() * 100)) });
+    }
+    if (m_sceneModel) {
+        const PlacementStore &placements = m_sceneModel->placements();
+        // As colocações não têm pixmap próprio: a camada de tiles desenha os do cache
+        consumers.append({ "Colocações", placements.memoryBytes(),
+                           QString("%1 colocações, pixmaps compartilhados pelo cache de tiles")
+                               .arg(placements.count()) });
+
+        const UndoHistory &history = m_sceneModel->history();
+        consumers.append({ "Histórico de undo/redo", history.memoryBytes(),
+                           QString("%1 passos de undo, %2 de redo, limite de %3 MB, %4 descartados")
+                               .arg(history.undoCount()).arg(history.redoCount())
+                               .arg(megabytes(history.memoryLimitBytes())).arg(history.droppedStepCount()) });
+
+        consumers.append({ "Journal de edições", m_sceneModel->journal().pendingBytes(),
+                           QString("buffer ainda não gravado") });
+    }
+    if (m_scene) {
+        // Pixmaps dos itens soltos (preview e afins); a grade é desenhada sem itens
+        QMap<QString, int> countByType;
+        qint64 pixmapBytes = 0;
+        const QList<QGraphicsItem*> items = m_scene->items();
+        for (const QGraphicsItem *item : items) {
+            ++countByType[itemTypeName(item)];
+            if (const QGraphicsPixmapItem *pixmapItem = qgraphicsitem_cast<const QGraphicsPixmapItem*>(item)) {
+                const QPixmap pixmap = pixmapItem->pixmap();
+                pixmapBytes += static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+            }
+        }
+        QStringList types;
+        for (auto it = countByType.constBegin(); it != countByType.constEnd(); ++it) {
+            types << QString("%1: %2").arg(it.key()).arg(it.value());
+        }
+        consumers.append({ "Itens da cena", pixmapBytes,
+                           QString("%1 itens (%2)").arg(items.size()).arg(types.join(", ")) });
+    }
+
+    std::sort(consumers.begin(), consumers.end(), [](const Consumer &a, const Consumer &b) {
+        return a.bytes > b.bytes;
+    });
+
+    m_consumerTable->setRowCount(consumers.size());
+    for (int row = 0; row < consumers.size(); ++row) {
+        const Consumer &consumer = consumers.at(row);
+        m_consumerTable->setItem(row, 0, new QTableWidgetItem(consumer.name));
+        m_consumerTable->setItem(row, 1, numberItem(megabytes(consumer.bytes)));
+        m_consumerTable->setItem(row, 2, new QTableWidgetItem(consumer.detail));
+    }
+}
+
+void MemoryDock::refreshEntities()
+{
+    QHash<const Entity*, EntityUsage> usage;
+    if (m_spritesheets) {
+        for (const auto &entry : m_spritesheets->decodedEntries()) {
+            usage.insert(entry.first, { entry.first, entry.second, 0 });
+        }
+    }
+    if (m_tileCache) {
+        const QHash<const Entity*, qint64> tileBytes = m_tileCache->bytesByEntity();
+        for (auto it = tileBytes.constBegin(); it != tileBytes.constEnd(); ++it) {
+            EntityUsage &entry = usage[it.key()];
+            entry.entity = it.key();
+            entry.tileBytes = it.value();
+        }
+    }
+
+    QVector<EntityUsage> ranked;
+    ranked.reserve(usage.size());
+    for (const EntityUsage &entry : usage) {
+        ranked.append(entry);
+    }
+    const int shown = qMin(ranked.size(), static_cast<int>(TopEntityCount));
+    std::partial_sort(ranked.begin(), ranked.begin() + shown, ranked.end(),
+                      [](const EntityUsage &a, const EntityUsage &b) {
+                          return a.spritesheetBytes + a.tileBytes > b.spritesheetBytes + b.tileBytes;
+                      });
+
+    m_entityTable->setRowCount(shown);
+    for (int row = 0; row < shown; ++row) {
+        const EntityUsage &entry = ranked.at(row);
+        m_entityTable->setItem(row, 0, new QTableWidgetItem(entry.entity->getName()));
+        m_entityTable->setItem(row, 1, numberItem(megabytes(entry.spritesheetBytes)));
+        m_entityTable->setItem(row, 2, numberItem(megabytes(entry.tileBytes)));
+        m_entityTable->setItem(row, 3, numberItem(megabytes(entry.spritesheetBytes + entry.tileBytes)));
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef MEMORYDOCK_H
+#define MEMORYDOCK_H
+
+#include <QDockWidget>
+
+class QGraphicsScene;
+class QTableWidget;
+class QTimer;
+class SceneModel;
+class SpritesheetCache;
+class TilePixmapCache;
+
+// Dock com a memória do editor por consumidor: spritesheets decodificados, cache de tiles,
+// colocações, itens da cena e histórico de undo/redo, do maior para o menor, e as entidades
+// que mais ocupam (spritesheet mais tiles em cache).
+//
+// Os números vêm dos contadores que os caches e o histórico já mantêm, mais uma passada
+// pelos itens da cena; a tabela só é atualizada, a cada RefreshIntervalMs, enquanto o dock
+// está visível.
+class MemoryDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RefreshIntervalMs = 1000;
+    static constexpr int TopEntityCount = 20;
+
+    explicit MemoryDock(QWidget *parent = nullptr);
+
+    void setSources(SceneModel *sceneModel, const QGraphicsScene *scene,
+                    const TilePixmapCache *tileCache, const SpritesheetCache *spritesheets);
+
+public slots:
+    void refresh();
+
+private:
+    void refreshConsumers();
+    void refreshEntities();
+
+    SceneModel *m_sceneModel;
+    const QGraphicsScene *m_scene;
+    const TilePixmapCache *m_tileCache;
+    const SpritesheetCache *m_spritesheets;
+
+    QTableWidget *m_consumerTable;
+    QTableWidget *m_entityTable;
+    QTimer *m_refreshTimer;
+};
+
+#endif // MEMORYDOCK_H
@@ -0,0 +1,137 @@
+#include "performancehud.h"
+#include "placementstore.h"
+#include "spritesheetcache.h"
+#include "tilepixmapcache.h"
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+const int Margin = 8;
+const int Padding = 6;
+const int LineCount = 5;
+
+QString megabytes(qint64 bytes)
+{
+    return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " MB";
+}
+
+}
+
+PerformanceHud::PerformanceHud()
+    : m_frameNsecs(FrameHistory, 0),
+      m_nextFrame(0),
+      m_frameCount(0),
+      m_placements(nullptr),
+      m_tileCache(nullptr),
+      m_spritesheets(nullptr),
+      m_font(QFontDatabase::systemFont(QFontDatabase::FixedFont))
+{
+    m_font.setPointSizeF(qMax(7.0, m_font.pointSizeF() * 0.9));
+    const QFontMetrics metrics(m_font);
+    m_lineHeight = metrics.height();
+    // Largura fixa: o retângulo não muda com os números e dá para repintar só ele
+    m_width = metrics.horizontalAdvance(QString(46, QLatin1Char('0'))) + 2 * Padding;
+}
+
+void PerformanceHud::setSources(const PlacementStore *placements, const TilePixmapCache *tileCache,
+                                const SpritesheetCache *spritesheets)
+{
+    m_placements = placements;
+    m_tileCache = tileCache;
+    m_spritesheets = spritesheets;
+}
+
+void PerformanceHud::recordFrame(qint64 nsecs, const QRect &exposedRect, const QSize &viewportSize)
+{
+    m_frameNsecs[m_nextFrame] = nsecs;
+    m_nextFrame = (m_nextFrame + 1) % FrameHistory;
+    m_frameCount = qMin(m_frameCount + 1, static_cast<int>(FrameHistory));
+    m_lastExposedRect = exposedRect;
+    m_viewportSize = viewportSize;
+}
+
+qreal PerformanceHud::lastFrameMs() const
+{
+    if (m_frameCount == 0) {
+        return 0;
+    }
+    return m_frameNsecs.at((m_nextFrame + FrameHistory - 1) % FrameHistory) / 1e6;
+}
+
+qreal PerformanceHud::percentileFrameMs(qreal percentile) const
+{
+    if (m_frameCount == 0) {
+        return 0;
+    }
+    // Com o anel ainda incompleto, só as posições já gravadas (0..m_frameCount-1) valem
+    QVector<qint64> samples(m_frameNsecs.constBegin(), m_frameNsecs.constBegin() + m_frameCount);
+    const int index = qBound(0, qCeil(percentile / 100.0 * samples.size()) - 1, samples.size() - 1);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples.at(index) / 1e6;
+}
+
+QStringList PerformanceHud::lines() const
+{
+    QStringList result;
+    result << QString("Frame: %1 ms  p99: %2 ms (%3 frames)")
+                  .arg(lastFrameMs(), 0, 'f', 2).arg(percentileFrameMs(99), 0, 'f', 2).arg(m_frameCount);
+
+    const int total = m_placements ? m_placements->count() : 0;
+    const int visible = m_placements && m_visibleSceneRect.isValid()
+                            ? m_placements->handlesIn(m_visibleSceneRect).size() : 0;
+    result << QString("Colocações: %1 visíveis de %2").arg(visible).arg(total);
+
+    const qint64 viewportArea = qint64(m_viewportSize.width()) * m_viewportSize.height();
+    const qint64 exposedArea = qint64(m_lastExposedRect.width()) * m_lastExposedRect.height();
+    result << QString("Exposto: %1x%2 px (%3% da viewport)")
+                  .arg(m_lastExposedRect.width()).arg(m_lastExposedRect.height())
+                  .arg(viewportArea > 0 ? qRound(100.0 * exposedArea / viewportArea) : 0);
+
+    if (m_tileCache) {
+        result << QString("Cache de tiles: %1% acertos, %2 pixmaps, %3")
+                      .arg(qRound(m_tileCache->hitRate() * 100)).arg(m_tileCache->count())
+                      .arg(megabytes(m_tileCache->bytes()));
+    }
+    if (m_spritesheets) {
+        result << QString("Imagens decodificadas: %1, %2 de %3")
+                      .arg(m_spritesheets->decodedCount()).arg(megabytes(m_spritesheets->decodedBytes()))
+                      .arg(megabytes(m_spritesheets->budgetBytes()));
+    }
+    return result;
+}
+
+QString PerformanceHud::report() const
+{
+    QStringList result = lines();
+    result.insert(1, QString("Frame p50: %1 ms  p90: %2 ms  máximo: %3 ms")
+                         .arg(percentileFrameMs(50), 0, 'f', 2).arg(percentileFrameMs(90), 0, 'f', 2)
+                         .arg(percentileFrameMs(100), 0, 'f', 2));
+    return result.join('\n');
+}
+
+QRect PerformanceHud::rect() const
+{
+    return QRect(Margin, Margin, m_width, LineCount * m_lineHeight + 2 * Padding);
+}
+
+void PerformanceHud::paint(QPainter *painter) const
+{
+    const QRect area = rect();
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->fillRect(area, QColor(0, 0, 0, 170));
+    painter->setFont(m_font);
+    painter->setPen(Qt::white);
+
+    const QStringList text = lines();
+    QRect line(area.left() + Padding, area.top() + Padding, area.width() - 2 * Padding, m_lineHeight);
+    for (const QString &entry : text) {
+        painter->drawText(line, Qt::AlignLeft | Qt::AlignVCenter, entry);
+        line.translate(0, m_lineHeight);
+    }
+    painter->restore();
+}
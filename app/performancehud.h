@@ -0,0 +1,67 @@
+#ifndef PERFORMANCEHUD_H
+#define PERFORMANCEHUD_H
+
+#include <QElapsedTimer>
+#include <QFont>
+#include <QRect>
+#include <QRectF>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QPainter;
+class PlacementStore;
+class SpritesheetCache;
+class TilePixmapCache;
+
+// Estatísticas de desenho mostradas sobre a cena pela SceneView.
+//
+// Os tempos de frame ficam num anel com os últimos FrameHistory paints; o resto é lido das
+// fontes (colocações, caches) só quando o HUD é desenhado ou despejado, então manter o HUD
+// ligado custa um texto pequeno no canto da viewport e uma consulta à grade por repaint.
+class PerformanceHud
+{
+public:
+    static constexpr int FrameHistory = 240;
+
+    PerformanceHud();
+
+    void setSources(const PlacementStore *placements, const TilePixmapCache *tileCache,
+                    const SpritesheetCache *spritesheets);
+    // Parte da cena mostrada pela viewport; as colocações visíveis são contadas nela, e não no
+    // retângulo exposto, que no repaint do próprio HUD é só o painel
+    void setVisibleSceneRect(const QRectF &rect) { m_visibleSceneRect = rect; }
+
+    // Um paint da viewport: duração e retângulo exposto, em pixels da viewport
+    void recordFrame(qint64 nsecs, const QRect &exposedRect, const QSize &viewportSize);
+
+    qreal lastFrameMs() const;
+    qreal percentileFrameMs(qreal percentile) const;
+    int frameCount() const { return m_frameCount; }
+
+    QStringList lines() const;
+    // Texto de várias linhas para o log, com os mesmos números do HUD
+    QString report() const;
+
+    // Área ocupada no canto da viewport, para repintar só ela
+    QRect rect() const;
+    void paint(QPainter *painter) const;
+
+private:
+    QVector<qint64> m_frameNsecs;
+    int m_nextFrame;
+    int m_frameCount;
+    QRect m_lastExposedRect;
+    QSize m_viewportSize;
+    QRectF m_visibleSceneRect;
+
+    const PlacementStore *m_placements;
+    const TilePixmapCache *m_tileCache;
+    const SpritesheetCache *m_spritesheets;
+
+    QFont m_font;
+    int m_lineHeight;
+    int m_width;
+};
+
+#endif // PERFORMANCEHUD_H
@@ -0,0 +1,122 @@
+#include "sceneview.h"
+#include "tracerecorder.h"
+#include <QElapsedTimer>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QTimer>
+#include <QVarLengthArray>
+#include <QtMath>
+
+SceneView::SceneView(QGraphicsScene *scene, QWidget *parent)
+    : QGraphicsView(scene, parent),
+      m_hudVisible(false),
+      m_hudTimer(new QTimer(this))
+{
+    m_hudTimer->setInterval(HudRefreshMs);
+    connect(m_hudTimer, &QTimer::timeout, this, [this]() { viewport()->update(m_hud.rect()); });
+}
+
+void SceneView::setGridCellSize(const QSizeF &cellSize)
+{
+    if (cellSize == m_gridCellSize) {
+        return;
+    }
+    m_gridCellSize = cellSize;
+    viewport()->update();
+}
+
+void SceneView::setHudVisible(bool visible)
+{
+    if (visible == m_hudVisible) {
+        return;
+    }
+    m_hudVisible = visible;
+    if (visible) {
+        m_hudTimer->start();
+    } else {
+        m_hudTimer->stop();
+    }
+    viewport()->update(m_hud.rect());
+}
+
+void SceneView::paintEvent(QPaintEvent *event)
+{
+    // O repaint inteiro da cena: fundo, camada de tiles, preview, grade e HUD
+    TraceSpan span("SceneView::paintEvent", "render");
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+
+    // Os repaints do próprio HUD não entram nos tempos de frame
+    const QRect exposed = event->rect();
+    if (!m_hudVisible || !m_hud.rect().contains(exposed)) {
+        m_hud.recordFrame(timer.nsecsElapsed(), exposed, viewport()->size());
+    }
+    m_inputProbe.framePainted(this, event->region());
+}
+
+void SceneView::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+
+    // O scroll da viewport leva junto os pixels do HUD; repinta o lugar fixo dele e a cópia
+    // deslocada, que nenhum outro update cobriria
+    if (m_hudVisible && (dx != 0 || dy != 0)) {
+        const QRect hudRect = m_hud.rect();
+        viewport()->update(hudRect);
+        viewport()->update(hudRect.translated(dx, dy));
+    }
+}
+
+void SceneView::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    drawGrid(painter, rect);
+
+    // Guardado também com o HUD escondido, para o despejo das estatísticas
+    m_hud.setVisibleSceneRect(mapToScene(viewport()->rect()).boundingRect());
+
+    if (m_hudVisible) {
+        // Em coordenadas da viewport, fora da transformação da cena
+        painter->save();
+        painter->resetTransform();
+        m_hud.paint(painter);
+        painter->restore();
+    }
+}
+
+void SceneView::drawGrid(QPainter *painter, const QRectF &rect)
+{
+    if (m_gridCellSize.isEmpty()) {
+        return;
+    }
+
+    // Passo em múltiplos da célula para as linhas não se amontoarem no zoom afastado
+    const qreal scale = qMax(qAbs(transform().m11()), qAbs(transform().m22()));
+    qreal stepX = m_gridCellSize.width();
+    qreal stepY = m_gridCellSize.height();
+    while (stepX * scale < MinLineSpacing) {
+        stepX *= 2;
+    }
+    while (stepY * scale < MinLineSpacing) {
+        stepY *= 2;
+    }
+
+    // Só as linhas que cruzam a área exposta
+    const qreal startX = qFloor(rect.left() / stepX) * stepX;
+    const qreal startY = qFloor(rect.top() / stepY) * stepY;
+    QVarLengthArray<QLineF, 256> lines;
+    for (qreal x = startX; x < rect.right(); x += stepX) {
+        lines.append(QLineF(x, rect.top(), x, rect.bottom()));
+    }
+    for (qreal y = startY; y < rect.bottom(); y += stepY) {
+        lines.append(QLineF(rect.left(), y, rect.right(), y));
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    QPen pen(Qt::lightGray, 1, Qt::DotLine);
+    pen.setCosmetic(true);
+    painter->setPen(pen);
+    painter->drawLines(lines.constData(), lines.size());
+    painter->restore();
+}
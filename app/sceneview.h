@@ -0,0 +1,55 @@
+#ifndef SCENEVIEW_H
+#define SCENEVIEW_H
+
+#include <QGraphicsView>
+#include <QSizeF>
+#include "inputlatencyprobe.h"
+#include "performancehud.h"
+
+class QTimer;
+
+// View da cena com a grade de encaixe desenhada no drawForeground().
+//
+// A grade não tem itens na cena: cada repaint desenha só as linhas que cruzam o retângulo
+// exposto, num único drawLines(). Com zoom afastado, as linhas são espaçadas em múltiplos da
+// célula para nunca ficarem a menos de MinLineSpacing pixels umas das outras.
+//
+// Também mede cada paint da viewport e, com o HUD ligado, desenha as estatísticas no canto
+// superior esquerdo; só o retângulo do HUD é repintado a cada HudRefreshMs. O fim de cada paint
+// também vai para o InputLatencyProbe, que fecha as medidas de entrada até pixel do preview.
+class SceneView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    static constexpr qreal MinLineSpacing = 8.0;
+    static constexpr int HudRefreshMs = 250;
+
+    explicit SceneView(QGraphicsScene *scene, QWidget *parent = nullptr);
+
+    // Tamanho vazio esconde a grade
+    void setGridCellSize(const QSizeF &cellSize);
+    QSizeF gridCellSize() const { return m_gridCellSize; }
+
+    PerformanceHud &hud() { return m_hud; }
+    void setHudVisible(bool visible);
+    bool isHudVisible() const { return m_hudVisible; }
+
+    InputLatencyProbe &inputProbe() { return m_inputProbe; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+
+private:
+    void drawGrid(QPainter *painter, const QRectF &rect);
+
+    QSizeF m_gridCellSize;
+    PerformanceHud m_hud;
+    InputLatencyProbe m_inputProbe;
+    bool m_hudVisible;
+    QTimer *m_hudTimer;
+};
+
+#endif // SCENEVIEW_H
@@ -0,0 +1,165 @@
+#include "tilelayeritem.h"
+#include "entity.h"
+#include "tilepixmapcache.h"
+#include "tracerecorder.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsSceneMouseEvent>
+
+TileLayerItem::TileLayerItem(PlacementStore *store, TilePixmapCache *tileCache, QGraphicsItem *parent)
+    : QGraphicsObject(parent),
+      m_store(store),
+      m_tileCache(tileCache),
+      m_interactive(false)
+{
+    // Necessário para receber o exposedRect no paint() e recortar o que é desenhado
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    updateBounds();
+}
+
+QRectF TileLayerItem::boundingRect() const
+{
+    // Margem para a caneta das entidades invisíveis e o contorno de seleção
+    return m_bounds.adjusted(-2, -2, 2, 2);
+}
+
+bool TileLayerItem::contains(const QPointF &point) const
+{
+    return m_store->topmostAt(point) != PlacementStore::InvalidHandle;
+}
+
+void TileLayerItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    TraceSpan span("TileLayerItem::paint", "render");
+    const QVector<int> visible = m_store->handlesIn(option->exposedRect);
+    span.addArg("placements", visible.size());
+    const QPen invisiblePen(Qt::red, 2, Qt::DashLine);
+    const QPen selectionPen(Qt::black, 0, Qt::DashLine);
+
+    // Colocações vizinhas costumam ser da mesma entidade: evita buscar o spritesheet a cada tile
+    const Entity *currentEntity = nullptr;
+    QPixmap spritesheet;
+    QVector<QRectF> spriteDefinitions;
+
+    for (int handle : visible) {
+        const EntityPlacement &placement = m_store->at(handle);
+        Entity *entity = placement.entity;
+        const QRectF target = placement.rect();
+
+        if (entity->isInvisible()) {
+            painter->setPen(invisiblePen);
+            painter->setBrush(Qt::NoBrush);
+            painter->drawRect(target);
+        } else if (entity->hasOnlyCollision()) {
+            painter->drawPixmap(target.topLeft(), m_tileCache->tilePixmap(entity, placement.tileIndex, target.size().toSize()));
+        } else {
+            if (entity != currentEntity) {
+                currentEntity = entity;
+                spritesheet = entity->getPixmap();
+                spriteDefinitions = entity->getSpriteDefinitions();
+            }
+            if (!spriteDefinitions.isEmpty()) {
+                const int tileIndex = (placement.tileIndex >= 0 && placement.tileIndex < spriteDefinitions.size())
+                                      ? placement.tileIndex : 0;
+                painter->drawPixmap(target, spritesheet, spriteDefinitions[tileIndex]);
+            }
+        }
+
+        if (placement.selected) {
+            painter->setPen(selectionPen);
+            painter->setBrush(Qt::NoBrush);
+            painter->drawRect(target);
+        }
+    }
+}
+
+void TileLayerItem::updateBounds()
+{
+    const QRectF bounds = m_store->boundingRect();
+    if (bounds != m_bounds) {
+        prepareGeometryChange();
+        m_bounds = bounds;
+    }
+}
+
+void TileLayerItem::placementsChanged(const QRectF &area)
+{
+    updateBounds();
+    update(area.adjusted(-2, -2, 2, 2));
+}
+
+void TileLayerItem::placementsChanged()
+{
+    updateBounds();
+    update();
+}
+
+void TileLayerItem::setInteractive(bool interactive)
+{
+    m_interactive = interactive;
+    m_dragHandles.clear();
+    m_dragOrigins.clear();
+}
+
+void TileLayerItem::selectInRect(const QRectF &rect)
+{
+    m_store->clearSelection();
+    for (int handle : m_store->handlesIn(rect)) {
+        m_store->setSelected(handle, true);
+    }
+    update();
+    emit placementSelectionChanged();
+}
+
+void TileLayerItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    const int handle = m_interactive ? m_store->topmostAt(event->scenePos()) : PlacementStore::InvalidHandle;
+    if (handle == PlacementStore::InvalidHandle) {
+        // Deixa a view iniciar o rubber band
+        event->ignore();
+        return;
+    }
+
+    if (event->modifiers() & Qt::ControlModifier) {
+        m_store->setSelected(handle, !m_store->at(handle).selected);
+    } else if (!m_store->at(handle).selected) {
+        m_store->clearSelection();
+        m_store->setSelected(handle, true);
+    }
+    update();
+    emit placementSelectionChanged();
+
+    m_dragStart = event->scenePos();
+    m_dragHandles = m_store->selectedHandles();
+    m_dragOrigins.clear();
+    m_dragOrigins.reserve(m_dragHandles.size());
+    for (int selected : m_dragHandles) {
+        m_dragOrigins.append(m_store->at(selected).pos());
+    }
+    event->accept();
+}
+
+void TileLayerItem::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
+{
+    if (m_dragHandles.isEmpty()) {
+        return;
+    }
+
+    const QPointF delta = event->scenePos() - m_dragStart;
+    for (int i = 0; i < m_dragHandles.size(); ++i) {
+        m_store->move(m_dragHandles[i], m_dragOrigins[i] + delta);
+    }
+    placementsChanged();
+}
+
+void TileLayerItem::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    if (!m_dragHandles.isEmpty() && event->scenePos() != m_dragStart) {
+        emit placementsMoved(m_dragHandles, m_dragOrigins);
+    }
+    m_dragHandles.clear();
+    m_dragOrigins.clear();
+}
@@ -0,0 +1,60 @@
+#ifndef TILELAYERITEM_H
+#define TILELAYERITEM_H
+
+#include <QGraphicsObject>
+#include <QVector>
+#include <QPointF>
+#include "placementstore.h"
+
+class TilePixmapCache;
+
+// Item único que desenha todas as colocações da cena em um só paint().
+//
+// As colocações ficam em um PlacementStore (sem um QGraphicsItem por entidade); o paint()
+// recorta pelo exposedRect e faz blits com retângulo de origem a partir do spritesheet
+// compartilhado da entidade. Quando interativo (ferramenta de seleção), também cuida de
+// escolher, selecionar e arrastar colocações individuais.
+class TileLayerItem : public QGraphicsObject
+{
+    Q_OBJECT
+
+public:
+    TileLayerItem(PlacementStore *store, TilePixmapCache *tileCache, QGraphicsItem *parent = nullptr);
+
+    QRectF boundingRect() const override;
+    bool contains(const QPointF &point) const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    // Deve ser chamado depois de alterar o PlacementStore
+    void placementsChanged(const QRectF &area);
+    void placementsChanged();
+
+    void setInteractive(bool interactive);
+    bool isInteractive() const { return m_interactive; }
+
+    void selectInRect(const QRectF &rect);
+
+signals:
+    void placementsMoved(const QVector<int> &handles, const QVector<QPointF> &oldPositions);
+    void placementSelectionChanged();
+
+protected:
+    void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+    void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
+
+private:
+    void updateBounds();
+
+    PlacementStore *m_store;
+    TilePixmapCache *m_tileCache;
+    QRectF m_bounds;
+    bool m_interactive;
+
+    // Arraste em andamento
+    QPointF m_dragStart;
+    QVector<int> m_dragHandles;
+    QVector<QPointF> m_dragOrigins;
+};
+
+#endif // TILELAYERITEM_H
@@ -0,0 +1,211 @@
+#include "tilepixmapcache.h"
+#include "asynclogger.h"
+#include "entity.h"
+#include <QDebug>
+#include <QPainter>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <limits>
+
+namespace {
+
+void drawSprite(QPainter &painter, const QRect &target, const QPixmap &spritesheet, const QRectF &source)
+{
+    painter.drawPixmap(QRectF(target), spritesheet, source);
+}
+
+void drawSprite(QPainter &painter, const QRect &target, const QImage &spritesheet, const QRectF &source)
+{
+    painter.drawImage(QRectF(target), spritesheet, source);
+}
+
+// Cópia do que o desenho precisa da entidade, para não tocar nela fora da thread da GUI
+struct TileDescription
+{
+    QString name;
+    bool isInvisible;
+    bool hasOnlyCollision;
+    QVector<QRectF> spriteDefinitions;
+};
+
+TileDescription describe(const Entity *entity)
+{
+    return { entity->getName(), entity->isInvisible(), entity->hasOnlyCollision(), entity->getSpriteDefinitions() };
+}
+
+// Mesmo desenho para QPixmap (thread da GUI) e QImage (pré-aquecimento em background)
+template <typename Spritesheet>
+void paintTile(QPainter &painter, const QRect &target, const TileDescription &entity, const Spritesheet &spritesheet, int tileIndex)
+{
+    if (entity.isInvisible) {
+        painter.setPen(QPen(Qt::red, 2));
+        painter.drawRect(target.adjusted(1, 1, -1, -1));
+        painter.setFont(QFont("Arial", 8));
+        QString text = entity.name;
+        QRectF textRect = painter.boundingRect(target, Qt::AlignCenter, text);
+        if (textRect.width() > target.width() - 4) {
+            text = painter.fontMetrics().elidedText(text, Qt::ElideRight, target.width() - 4);
+        }
+        painter.drawText(target, Qt::AlignCenter, text);
+    } else if (entity.hasOnlyCollision) {
+        painter.setPen(QPen(Qt::blue, 2));
+        painter.drawRect(target.adjusted(1, 1, -1, -1));
+        painter.drawText(target, Qt::AlignCenter, "Collision");
+    } else {
+        const QVector<QRectF> &spriteDefinitions = entity.spriteDefinitions;
+        if (tileIndex >= 0 && tileIndex < spriteDefinitions.size()) {
+            drawSprite(painter, target, spritesheet, spriteDefinitions[tileIndex]);
+        } else {
+            qWarning() << "Índice de tile inválido:" << tileIndex << ". Usando o primeiro sprite.";
+            if (!spriteDefinitions.isEmpty()) {
+                drawSprite(painter, target, spritesheet, spriteDefinitions[0]);
+            }
+        }
+    }
+}
+
+// Tile em QImage, que pode ser desenhado fora da thread da GUI (pré-aquecimento)
+QImage renderTileImage(const TileDescription &entity, const QImage &spritesheet, int tileIndex, const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    paintTile(painter, image.rect(), entity, spritesheet, tileIndex);
+    return image;
+}
+
+struct PrewarmResult
+{
+    QVector<int> tileIndices;
+    QVector<QImage> images;
+};
+
+}
+
+TilePixmapCache::TilePixmapCache(QObject *parent, qint64 budgetBytes)
+    : QObject(parent),
+      m_hits(0),
+      m_misses(0),
+      m_generation(0)
+{
+    m_cache.setMaxCost(static_cast<int>(qMin<qint64>(budgetBytes / 1024, std::numeric_limits<int>::max())));
+}
+
+qreal TilePixmapCache::hitRate() const
+{
+    const qint64 total = m_hits + m_misses;
+    return total > 0 ? static_cast<qreal>(m_hits) / total : 0.0;
+}
+
+// keys() não mexe na ordem do LRU, ao contrário de object()
+QHash<const Entity*, qint64> TilePixmapCache::bytesByEntity() const
+{
+    QHash<const Entity*, qint64> result;
+    const QList<TileKey> keys = m_cache.keys();
+    for (const TileKey &key : keys) {
+        result[key.entity] += static_cast<qint64>(key.width) * key.height * 4;
+    }
+    return result;
+}
+
+TilePixmapCache::TileKey TilePixmapCache::makeKey(const Entity *entity, int tileIndex, const QSize &size)
+{
+    return { entity, tileIndex, size.width(), size.height() };
+}
+
+void TilePixmapCache::insert(const TileKey &key, const QPixmap &pixmap)
+{
+    const qint64 bytes = static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    m_cache.insert(key, new QPixmap(pixmap), qMax(1, static_cast<int>(bytes / 1024)));
+}
+
+QPixmap TilePixmapCache::tilePixmap(Entity *entity, int tileIndex, const QSize &size)
+{
+    if (!entity) {
+        QPixmap pixmap(size);
+        pixmap.fill(Qt::transparent);
+        return pixmap;
+    }
+
+    const TileKey key = makeKey(entity, tileIndex, size);
+    if (QPixmap *cached = m_cache.object(key)) {
+        ++m_hits;
+        return *cached;
+    }
+
+    ++m_misses;
+    // Invisíveis e só de colisão não usam o spritesheet; evita decodificá-lo à toa
+    QPixmap spritesheet;
+    if (!entity->isInvisible() && !entity->hasOnlyCollision()) {
+        spritesheet = entity->getPixmap();
+    }
+    QPixmap pixmap = renderTilePixmap(entity, spritesheet, tileIndex, size);
+    insert(key, pixmap);
+    return pixmap;
+}
+
+QPixmap TilePixmapCache::renderTilePixmap(const Entity *entity, const QPixmap &spritesheet, int tileIndex, const QSize &size)
+{
+    QPixmap pixmap(size);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    paintTile(painter, pixmap.rect(), describe(entity), spritesheet, tileIndex);
+    return pixmap;
+}
+
+void TilePixmapCache::prewarm(Entity *entity, const QSize &size)
+{
+    if (!entity || size.isEmpty()) {
+        return;
+    }
+
+    const int tileCount = qMax(1, entity->getSpriteDefinitions().size());
+    QVector<int> missing;
+    for (int tileIndex = 0; tileIndex < tileCount; ++tileIndex) {
+        if (!m_cache.contains(makeKey(entity, tileIndex, size))) {
+            missing.append(tileIndex);
+        }
+    }
+    if (missing.isEmpty()) {
+        return;
+    }
+
+    // A imagem decodificada é compartilhada implicitamente e só lida pela thread de trabalho
+    QImage spritesheet;
+    if (!entity->isInvisible() && !entity->hasOnlyCollision()) {
+        spritesheet = entity->getPixmap().toImage();
+    }
+
+    const int generation = m_generation;
+    auto *watcher = new QFutureWatcher<PrewarmResult>(this);
+    connect(watcher, &QFutureWatcher<PrewarmResult>::finished, this, [this, watcher, entity, size, generation]() {
+        watcher->deleteLater();
+        if (generation != m_generation) {
+            return;  // O catálogo foi recarregado; a entidade pode não existir mais
+        }
+        const PrewarmResult result = watcher->result();
+        for (int i = 0; i < result.tileIndices.size(); ++i) {
+            const TileKey key = makeKey(entity, result.tileIndices[i], size);
+            if (!m_cache.contains(key)) {
+                insert(key, QPixmap::fromImage(result.images[i]));
+            }
+        }
+        SCENE_LOG_DEBUG("TilePixmapCache") << "Pré-aquecimento concluído:" << entity->getName() << "-" << result.tileIndices.size() << "tiles";
+    });
+    const TileDescription description = describe(entity);
+    watcher->setFuture(QtConcurrent::run([description, spritesheet, missing, size]() {
+        PrewarmResult result;
+        result.tileIndices = missing;
+        result.images.reserve(missing.size());
+        for (int tileIndex : missing) {
+            result.images.append(renderTileImage(description, spritesheet, tileIndex, size));
+        }
+        return result;
+    }));
+}
+
+void TilePixmapCache::clear()
+{
+    m_cache.clear();
+    ++m_generation;
+}
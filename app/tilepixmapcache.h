@@ -0,0 +1,78 @@
+#ifndef TILEPIXMAPCACHE_H
+#define TILEPIXMAPCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+#include <QSize>
+
+class Entity;
+
+// Cache dos pixmaps de tile usados pelas colocações, pelo preview e pelo undo.
+//
+// A chave é (entidade, índice do tile, tamanho), e o valor é um QPixmap compartilhado
+// implicitamente: 50 mil colocações do mesmo tile apontam para os mesmos pixels.
+// Também guarda os bitmaps desenhados para entidades invisíveis e só de colisão,
+// cujo desenho de texto é caro. Usado apenas na thread da GUI.
+class TilePixmapCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 DefaultBudgetBytes = 64LL * 1024 * 1024;
+
+    explicit TilePixmapCache(QObject *parent = nullptr, qint64 budgetBytes = DefaultBudgetBytes);
+
+    QPixmap tilePixmap(Entity *entity, int tileIndex, const QSize &size);
+
+    // Renderiza em background todos os tiles da entidade que ainda não estão no cache
+    void prewarm(Entity *entity, const QSize &size);
+
+    // Invalida tudo (por exemplo, quando o catálogo de entidades é recarregado)
+    void clear();
+
+    qint64 hits() const { return m_hits; }
+    qint64 misses() const { return m_misses; }
+    qreal hitRate() const;
+    int count() const { return m_cache.count(); }
+    qint64 bytes() const { return static_cast<qint64>(m_cache.totalCost()) * 1024; }
+    // Bytes por entidade, estimados pelo tamanho dos tiles em cache (32 bits por pixel)
+    QHash<const Entity*, qint64> bytesByEntity() const;
+
+    // Desenho de um tile a partir do spritesheet, na thread da GUI
+    static QPixmap renderTilePixmap(const Entity *entity, const QPixmap &spritesheet, int tileIndex, const QSize &size);
+
+private:
+    struct TileKey
+    {
+        const Entity *entity;
+        int tileIndex;
+        int width;
+        int height;
+
+        bool operator==(const TileKey &other) const
+        {
+            return entity == other.entity && tileIndex == other.tileIndex
+                   && width == other.width && height == other.height;
+        }
+
+        friend uint qHash(const TileKey &key, uint seed)
+        {
+            const quint64 packed = (static_cast<quint64>(static_cast<quint32>(key.tileIndex)) << 32)
+                                   ^ (static_cast<quint64>(static_cast<quint32>(key.width)) << 16)
+                                   ^ static_cast<quint32>(key.height);
+            return ::qHash(reinterpret_cast<quintptr>(key.entity), seed) ^ ::qHash(packed, seed);
+        }
+    };
+
+    static TileKey makeKey(const Entity *entity, int tileIndex, const QSize &size);
+    void insert(const TileKey &key, const QPixmap &pixmap);
+
+    QCache<TileKey, QPixmap> m_cache;  // custo em KiB (QCache usa int)
+    qint64 m_hits;
+    qint64 m_misses;
+    int m_generation;
+};
+
+#endif // TILEPIXMAPCACHE_H
@@ -0,0 +1,66 @@
+#include "benchmarkreport.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+
+bool BenchmarkReport::convertXmlToJson(const QString &xmlPath, const QString &jsonPath, const QString &revision)
+{
+    QFile xmlFile(xmlPath);
+    if (!xmlFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Não foi possível abrir a saída XML do QtTest:" << xmlPath;
+        return false;
+    }
+
+    QJsonObject report;
+    QJsonArray results;
+    QString function;
+
+    // <TestCase name><Environment><QtVersion/></Environment>
+    // <TestFunction name><BenchmarkResult metric tag value iterations/></TestFunction></TestCase>
+    QXmlStreamReader xml(&xmlFile);
+    while (!xml.atEnd() && !xml.hasError()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestCase")) {
+            report["testCase"] = attributes.value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("QtVersion")) {
+            report["qtVersion"] = xml.readElementText();
+        } else if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            const double total = attributes.value(QLatin1String("value")).toDouble();
+            const int iterations = attributes.value(QLatin1String("iterations")).toInt();
+            QJsonObject result;
+            result["function"] = function;
+            result["tag"] = attributes.value(QLatin1String("tag")).toString();
+            result["metric"] = attributes.value(QLatin1String("metric")).toString();
+            result["value"] = iterations > 0 ? total / iterations : total;
+            result["iterations"] = iterations;
+            result["total"] = total;
+            results.append(result);
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "Erro ao ler a saída XML do QtTest:" << xml.errorString();
+        return false;
+    }
+
+    report["revision"] = revision;
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["results"] = results;
+
+    QSaveFile jsonFile(jsonPath);
+    if (!jsonFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar o JSON dos benchmarks:" << jsonPath;
+        return false;
+    }
+    jsonFile.write(QJsonDocument(report).toJson());
+    return jsonFile.commit();
+}
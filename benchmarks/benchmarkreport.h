@@ -0,0 +1,18 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QString>
+
+// Converte a saída XML do QtTest num JSON para comparar execuções entre revisões:
+//
+//   { "testCase", "revision", "qtVersion", "timestamp",
+//     "results": [ { "function", "tag", "metric", "value", "iterations", "total" } ] }
+//
+// "value" é o valor por iteração (o que o QtTest mostra no console), "total" é a soma medida.
+class BenchmarkReport
+{
+public:
+    static bool convertXmlToJson(const QString &xmlPath, const QString &jsonPath, const QString &revision);
+};
+
+#endif // BENCHMARKREPORT_H
@@ -0,0 +1,29 @@
+# Benchmarks QtTest dos caminhos quentes; sem tela, com saída em JSON para comparar revisões:
+#   ./scenebench -json resultados.json
+#   ./scenebench importScene saveScene -iterations 5
+QT = core gui concurrent testlib
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = scenebench
+
+include(../core/core.pri)
+
+# TilePixmapCache é do editor, mas não depende de QtWidgets
+INCLUDEPATH += ../app
+
+# Revisão gravada no JSON, para comparar execuções entre commits
+SCENEBENCH_REVISION = $$system(git -C $$shell_quote($$PWD) describe --always --dirty)
+DEFINES += SCENEBENCH_REVISION=\\\"$$SCENEBENCH_REVISION\\\"
+
+SOURCES += \
+    main.cpp \
+    benchmarkreport.cpp \
+    scenebenchmarks.cpp \
+    ../app/tilepixmapcache.cpp
+
+HEADERS += \
+    benchmarkreport.h \
+    scenebenchmarks.h \
+    ../app/tilepixmapcache.h
@@ -0,0 +1,44 @@
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QtTest>
+#include "benchmarkreport.h"
+#include "scenebenchmarks.h"
+
+#ifndef SCENEBENCH_REVISION
+#define SCENEBENCH_REVISION ""
+#endif
+
+// Roda os benchmarks como um teste QtTest comum (aceita os mesmos argumentos: -iterations,
+// -callgrind, nomes de funções...) e, com -json <arquivo>, grava também o resultado em JSON.
+// Sem QT_QPA_PLATFORM definido, usa a plataforma offscreen: os pixmaps não precisam de tela.
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    QStringList arguments = app.arguments();
+    QString jsonPath;
+    const int jsonIndex = arguments.indexOf("-json");
+    if (jsonIndex > 0 && jsonIndex + 1 < arguments.size()) {
+        jsonPath = arguments.at(jsonIndex + 1);
+        arguments.erase(arguments.begin() + jsonIndex, arguments.begin() + jsonIndex + 2);
+    }
+
+    // O JSON sai do XML do QtTest; o console continua com a saída de texto de sempre
+    QTemporaryDir xmlDir;
+    const QString xmlPath = xmlDir.filePath("scenebench.xml");
+    if (!jsonPath.isEmpty()) {
+        arguments << "-o" << xmlPath + ",xml" << "-o" << "-,txt";
+    }
+
+    SceneBenchmarks benchmarks;
+    const int failures = QTest::qExec(&benchmarks, arguments);
+
+    if (!jsonPath.isEmpty()
+        && !BenchmarkReport::convertXmlToJson(xmlPath, jsonPath, QString::fromUtf8(SCENEBENCH_REVISION))) {
+        return failures ? failures : 1;
+    }
+    return failures;
+}
@@ -0,0 +1,581 @@
+#include "scenebenchmarks.h"
+#include "asynclogger.h"
+#include "binaryscenefile.h"
+#include "entity.h"
+#include "entitymanager.h"
+#include "placementstore.h"
+#include "scenemodel.h"
+#include "sceneserializer.h"
+#include "tilepixmapcache.h"
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QLoggingCategory>
+#include <QPainter>
+#include <QTextStream>
+#include <QtTest>
+
+namespace {
+
+// Grade das cenas geradas: 256 colunas de 128 px
+const int SceneColumns = 256;
+const qreal SceneSpacing = 128;
+
+const int SpriteCutColumns = 8;
+const int SpriteCutRows = 4;
+const int AtlasSpriteCount = 32;
+
+QPointF gridPosition(int index)
+{
+    return QPointF((index % SceneColumns) * SceneSpacing, (index / SceneColumns) * SceneSpacing);
+}
+
+bool writeFile(const QString &path, const QByteArray &contents)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+// Spritesheet 1024x512 com um tile de 128x128 de cor diferente por célula
+bool writeSpritesheet(const QString &path)
+{
+    QImage image(1024, 512, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 8; ++column) {
+            painter.fillRect(column * 128, row * 128, 128, 128, QColor::fromHsv((row * 8 + column) * 11, 200, 220));
+            painter.drawRect(column * 128 + 8, row * 128 + 8, 111, 111);
+        }
+    }
+    painter.end();
+    return image.save(path, "PNG");
+}
+
+QByteArray entityXml(const QByteArray &spriteElements, int collisionSize)
+{
+    return "<?xml version=\"1.0\" ?>\n"
+           "<Ethanon>\n"
+           "    <Entity shape=\"1\" sensor=\"0\" static=\"1\" type=\"0\" blendMode=\"0\">\n"
+           + spriteElements +
+           "        <Particles />\n"
+           "        <Collision>\n"
+           "            <Position x=\"0\" y=\"0\" z=\"0\" />\n"
+           "            <Size x=\"" + QByteArray::number(collisionSize) + "\" y=\"" + QByteArray::number(collisionSize)
+           + "\" z=\"1\" />\n"
+           "        </Collision>\n"
+           "    </Entity>\n"
+           "</Ethanon>\n";
+}
+
+QByteArray atlasXml()
+{
+    QByteArray xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<TextureAtlas imagePath=\"atlas.png\" width=\"1024\" height=\"512\">\n";
+    for (int i = 0; i < AtlasSpriteCount; ++i) {
+        const int x = (i % 8) * 128;
+        const int y = (i / 8) * 128;
+        xml += "    <sprite n=\"tile-" + QByteArray::number(i) + ".png\" x=\"" + QByteArray::number(x)
+               + "\" y=\"" + QByteArray::number(y) + "\" w=\"128\" h=\"128\" oX=\"0\" oY=\"0\" oW=\"128\" oH=\"128\"/>\n";
+    }
+    xml += "</TextureAtlas>\n";
+    return xml;
+}
+
+// O que o placeEntityInScene do editor loga a cada colocação do pincel
+void logPlacement(Entity *entity, const QPointF &pos, const QSizeF &size)
+{
+    SCENE_LOG_DEBUG("MainWindow") << "Iniciando colocação de entidade:" << entity->getName();
+    SCENE_LOG_DEBUG("MainWindow") << "Posição inicial:" << pos;
+    SCENE_LOG_DEBUG("MainWindow") << "Entidade é invisível:" << entity->isInvisible();
+    SCENE_LOG_TRACE("MainWindow") << "Grade atualizada";
+    SCENE_LOG_INFO("MainWindow") << "Entidade colocada na cena:" << entity->getName() << "na posição:" << pos
+                                 << "com tamanho:" << size;
+}
+
+// O logToFile antigo: data formatada, write e flush síncronos a cada colocação
+void logPlacementToFile(QFile &file, Entity *entity)
+{
+    QTextStream out(&file);
+    out << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz ")
+        << "Entidade colocada na cena: " + entity->getName() << "\n";
+    out.flush();
+}
+
+}
+
+SceneBenchmarks::SceneBenchmarks()
+    : m_entityManager(nullptr),
+      m_cutEntity(nullptr),
+      m_atlasEntity(nullptr),
+      m_collisionEntity(nullptr)
+{
+}
+
+SceneBenchmarks::~SceneBenchmarks()
+{
+    delete m_entityManager;
+}
+
+QString SceneBenchmarks::entitiesPath() const
+{
+    return m_projectDir.filePath("entities");
+}
+
+QString SceneBenchmarks::scenePath(int count, const QString &suffix) const
+{
+    return m_projectDir.filePath(QString("scene_%1.%2").arg(count).arg(suffix));
+}
+
+void SceneBenchmarks::addSceneSizeRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void SceneBenchmarks::populate(SceneModel &model, int count) const
+{
+    Entity *entities[] = { m_cutEntity, m_atlasEntity, m_collisionEntity };
+    model.placements().reserve(count);
+    model.placements().suspendIndexing();
+    for (int i = 0; i < count; ++i) {
+        Entity *entity = entities[i % 3];
+        model.addPlacement(entity, i % entity->getSpriteDefinitions().size(), gridPosition(i), false);
+    }
+    model.placements().resumeIndexing();
+}
+
+void SceneBenchmarks::initTestCase()
+{
+    // As mensagens de depuração do loader iriam para o console a cada iteração
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QVERIFY(m_projectDir.isValid());
+    QVERIFY(QDir(m_projectDir.path()).mkpath("entities"));
+    const QDir entitiesDir(entitiesPath());
+
+    QVERIFY(writeSpritesheet(entitiesDir.filePath("cut.png")));
+    QVERIFY(writeSpritesheet(entitiesDir.filePath("atlas.png")));
+    QVERIFY(writeFile(entitiesDir.filePath("atlas.xml"), atlasXml()));
+
+    const QByteArray cutSprite = "        <SpriteCut x=\"" + QByteArray::number(SpriteCutColumns) + "\" y=\""
+                                 + QByteArray::number(SpriteCutRows) + "\" />\n"
+                                 "        <Sprite>cut.png</Sprite>\n";
+    const QByteArray atlasSprite = "        <Sprite>atlas.png</Sprite>\n";
+    for (int i = 0; i < CatalogEntitiesPerKind; ++i) {
+        const QString suffix = QString("_%1.ent").arg(i, 3, 10, QChar('0'));
+        QVERIFY(writeFile(entitiesDir.filePath("cut" + suffix), entityXml(cutSprite, 128)));
+        QVERIFY(writeFile(entitiesDir.filePath("atlas" + suffix), entityXml(atlasSprite, 128)));
+        QVERIFY(writeFile(entitiesDir.filePath("box" + suffix), entityXml(QByteArray(), 64)));
+    }
+
+    m_entityManager = new EntityManager();
+    m_entityManager->setCatalogCacheEnabled(false);
+    m_entityManager->loadEntitiesFromDirectory(entitiesPath());
+    m_cutEntity = m_entityManager->getEntityByName("cut_000");
+    m_atlasEntity = m_entityManager->getEntityByName("atlas_000");
+    m_collisionEntity = m_entityManager->getEntityByName("box_000");
+    QVERIFY(m_cutEntity && m_atlasEntity && m_collisionEntity);
+    QCOMPARE(m_cutEntity->getSpriteDefinitions().size(), SpriteCutColumns * SpriteCutRows);
+    QCOMPARE(m_atlasEntity->getSpriteDefinitions().size(), AtlasSpriteCount);
+
+    // Cenas usadas pelo importScene, nos dois formatos
+    for (int count : { 1000, 10000, 100000 }) {
+        SceneModel model(m_entityManager);
+        model.setJournalEnabled(false);
+        populate(model, count);
+        QVERIFY(model.saveScene(scenePath(count, "esc")));
+        QVERIFY(model.saveScene(scenePath(count, "escb")));
+        model.clear();
+    }
+}
+
+void SceneBenchmarks::cleanupTestCase()
+{
+    delete m_entityManager;
+    m_entityManager = nullptr;
+}
+
+void SceneBenchmarks::entityConstruction_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::newRow("SpriteCut") << "cut_000";
+    QTest::newRow("TextureAtlas") << "atlas_000";
+}
+
+void SceneBenchmarks::entityConstruction()
+{
+    QFETCH(QString, name);
+    const QString filePath = QDir(entitiesPath()).filePath(name + ".ent");
+
+    QBENCHMARK {
+        Entity entity(Entity::loadDefinition(name, filePath));
+        QVERIFY(!entity.getSpriteDefinitions().isEmpty());
+    }
+}
+
+void SceneBenchmarks::catalogLoad_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("sequential") << false << false;
+    QTest::newRow("parallel") << true << false;
+    QTest::newRow("parallel/catalog cache") << true << true;
+}
+
+void SceneBenchmarks::catalogLoad()
+{
+    QFETCH(bool, parallel);
+    QFETCH(bool, cached);
+    const EntityManager::LoadMode mode = parallel ? EntityManager::LoadMode::Parallel
+                                                  : EntityManager::LoadMode::Sequential;
+
+    if (cached) {
+        // Primeira carga grava o catálogo; as medidas usam só o cache
+        EntityManager manager;
+        manager.loadEntitiesFromDirectory(entitiesPath(), mode);
+    }
+
+    QBENCHMARK {
+        EntityManager manager;
+        manager.setCatalogCacheEnabled(cached);
+        manager.loadEntitiesFromDirectory(entitiesPath(), mode);
+        QCOMPARE(manager.getAllEntities().size(), CatalogEntitiesPerKind * 3);
+    }
+}
+
+void SceneBenchmarks::createEntityPixmap_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("SpriteCut/render") << "cut_000" << false;
+    QTest::newRow("SpriteCut/cache") << "cut_000" << true;
+    QTest::newRow("TextureAtlas/render") << "atlas_000" << false;
+    QTest::newRow("TextureAtlas/cache") << "atlas_000" << true;
+    QTest::newRow("collision/render") << "box_000" << false;
+}
+
+void SceneBenchmarks::createEntityPixmap()
+{
+    QFETCH(QString, name);
+    QFETCH(bool, cached);
+    Entity *entity = m_entityManager->getEntityByName(name);
+    QVERIFY(entity);
+    const QSize size = SceneModel::placementSize(entity).toSize();
+    const int tileCount = entity->getSpriteDefinitions().size();
+
+    // O spritesheet é decodificado uma vez só, como no editor
+    entity->getPixmap();
+
+    TilePixmapCache cache;
+    cache.tilePixmap(entity, 0, size);
+    int tileIndex = 0;
+    QBENCHMARK {
+        if (!cached) {
+            cache.clear();
+            tileIndex = (tileIndex + 1) % tileCount;
+        }
+        QVERIFY(!cache.tilePixmap(entity, tileIndex, size).isNull());
+    }
+}
+
+void SceneBenchmarks::placeEntity_data()
+{
+    addSceneSizeRows();
+}
+
+void SceneBenchmarks::placeEntity()
+{
+    QFETCH(int, count);
+    SceneModel model(m_entityManager);
+    populate(model, count);
+
+    // Uma colocação do pincel por iteração, com histórico, sobre a cena já cheia
+    int i = 0;
+    QBENCHMARK {
+        model.addPlacement(m_atlasEntity, i % AtlasSpriteCount, QPointF((i % 97) * 64.0, (i / 97 % 97) * 64.0));
+        ++i;
+    }
+    model.clear();
+}
+
+void SceneBenchmarks::placementLogging_data()
+{
+    QTest::addColumn<QString>("mode");
+    QTest::newRow("desligado") << "off";
+    QTest::newRow("info") << "info";
+    QTest::newRow("debug") << "debug";
+    QTest::newRow("logToFile") << "logToFile";
+}
+
+void SceneBenchmarks::placementLogging()
+{
+    QFETCH(QString, mode);
+    SceneModel model(m_entityManager);
+    populate(model, 10000);
+
+    // Mesma colocação do placeEntity, com as linhas de log do editor em volta; a diferença
+    // para "desligado" é o custo do log por colocação na thread da interface
+    const QString logPath = QDir(m_projectDir.path()).filePath("placement.log");
+    QFile syncFile(logPath);
+    const AsyncLogger::Level previousLevel = AsyncLogger::level();
+    AsyncLogger::Level level = AsyncLogger::Off;
+    if (mode == "logToFile") {
+        QVERIFY(syncFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text));
+    } else {
+        QVERIFY(AsyncLogger::parseLevel(mode, &level));
+        AsyncLogger::setLevel(level);
+        QVERIFY(AsyncLogger::instance().start(logPath));
+    }
+
+    const QSizeF size = SceneModel::placementSize(m_atlasEntity);
+    const quint64 droppedBefore = AsyncLogger::instance().droppedCount();
+    int i = 0;
+    QBENCHMARK {
+        const QPointF pos((i % 97) * 64.0, (i / 97 % 97) * 64.0);
+        model.addPlacement(m_atlasEntity, i % AtlasSpriteCount, pos);
+        if (syncFile.isOpen()) {
+            logPlacementToFile(syncFile, m_atlasEntity);
+        } else {
+            logPlacement(m_atlasEntity, pos, size);
+        }
+        ++i;
+    }
+
+    AsyncLogger::instance().stop();
+    AsyncLogger::setLevel(previousLevel);
+    const quint64 dropped = AsyncLogger::instance().droppedCount() - droppedBefore;
+    if (dropped > 0) {
+        qInfo() << "Mensagens descartadas com o buffer cheio:" << dropped;
+    }
+    model.clear();
+}
+
+void SceneBenchmarks::eraseEntity_data()
+{
+    addSceneSizeRows();
+}
+
+void SceneBenchmarks::eraseEntity()
+{
+    QFETCH(int, count);
+    SceneModel model(m_entityManager);
+    populate(model, count);
+
+    // A borracha (64x64, o tamanho da menor entidade) apaga a colocação da célula; ela volta
+    // sem histórico para a cena não esvaziar
+    int i = 0;
+    QBENCHMARK {
+        const int target = model.eraseTarget(QRectF(gridPosition(i % count), QSizeF(64, 64)));
+        QVERIFY(target != PlacementStore::InvalidHandle);
+        const EntityPlacement placement = model.placements().at(target);
+        model.removePlacement(target);
+        model.addPlacement(placement.entity, placement.tileIndex, placement.pos(), false, placement.id);
+        ++i;
+    }
+    model.clear();
+}
+
+void SceneBenchmarks::undoRedo_data()
+{
+    addSceneSizeRows();
+}
+
+void SceneBenchmarks::undoRedo()
+{
+    QFETCH(int, count);
+    SceneModel model(m_entityManager);
+    populate(model, count);
+
+    // Um passo com 100 movimentos, como um arraste de seleção
+    const QVector<int> handles = model.placements().handles().mid(0, 100);
+    model.beginStep();
+    for (int handle : handles) {
+        model.movePlacement(handle, model.placements().at(handle).pos() + QPointF(16, 16));
+    }
+    model.endStep();
+
+    QBENCHMARK {
+        QVERIFY(model.undo());
+        QVERIFY(model.redo());
+    }
+    model.clear();
+}
+
+void SceneBenchmarks::placementQueries_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QString>("query");
+    for (int count : { 10000, 100000, 1000000 }) {
+        const QString size = count >= 1000000 ? QString("%1M").arg(count / 1000000) : QString("%1k").arg(count / 1000);
+        for (const char *query : { "point", "rect", "nearest" }) {
+            QTest::newRow(qPrintable(QString("%1/%2").arg(query).arg(size))) << count << QString(query);
+        }
+    }
+}
+
+void SceneBenchmarks::placementQueries()
+{
+    QFETCH(int, count);
+    QFETCH(QString, query);
+
+    // Direto na store: é o que a borracha, o conta-gotas, o cursor e a seleção consultam.
+    // Colocações de 96 px a cada 128 px, para o conta-gotas cair no vão entre elas.
+    PlacementStore store;
+    store.reserve(count);
+    store.suspendIndexing();
+    for (int i = 0; i < count; ++i) {
+        store.add(m_atlasEntity, i % AtlasSpriteCount, gridPosition(i), QSizeF(96, 96));
+    }
+    store.resumeIndexing();
+
+    int i = 0;
+    int found = 0;
+    QBENCHMARK {
+        // Passo primo para espalhar as consultas pela cena
+        const QPointF cell = gridPosition(static_cast<int>((static_cast<qint64>(i) * 7919) % count));
+        if (query == "point") {
+            found += store.topmostAt(cell + QPointF(48, 48)) != PlacementStore::InvalidHandle;
+        } else if (query == "rect") {
+            found += store.handlesIn(QRectF(cell - QPointF(208, 208), QSizeF(512, 512))).size();
+        } else {
+            found += store.nearest(cell + QPointF(112, 112), 64) != PlacementStore::InvalidHandle;
+        }
+        ++i;
+    }
+    QVERIFY(found > 0);
+}
+
+void SceneBenchmarks::importScene_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QString>("format");
+    for (const char *format : { "esc", "escb" }) {
+        QTest::newRow(qPrintable(QString("%1/1k").arg(format))) << 1000 << QString(format);
+        QTest::newRow(qPrintable(QString("%1/10k").arg(format))) << 10000 << QString(format);
+        QTest::newRow(qPrintable(QString("%1/100k").arg(format))) << 100000 << QString(format);
+    }
+}
+
+void SceneBenchmarks::importScene()
+{
+    QFETCH(int, count);
+    QFETCH(QString, format);
+    SceneModel model(m_entityManager);
+    model.setJournalEnabled(false);
+
+    QBENCHMARK {
+        SceneModel::FileStats stats;
+        QVERIFY(model.importScene(scenePath(count, format), &stats));
+        QCOMPARE(stats.entityCount, count);
+    }
+    model.clear();
+}
+
+void SceneBenchmarks::saveScene_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<bool>("incremental");
+    for (int count : { 1000, 10000, 100000 }) {
+        const QString size = QString("%1k").arg(count / 1000);
+        QTest::newRow(qPrintable("esc/full/" + size)) << count << QString("esc") << false;
+        QTest::newRow(qPrintable("esc/incremental/" + size)) << count << QString("esc") << true;
+        QTest::newRow(qPrintable("escb/" + size)) << count << QString("escb") << false;
+    }
+}
+
+void SceneBenchmarks::saveScene()
+{
+    QFETCH(int, count);
+    QFETCH(QString, format);
+    QFETCH(bool, incremental);
+    SceneModel model(m_entityManager);
+    model.setJournalEnabled(false);
+    populate(model, count);
+
+    const QString path = scenePath(count, "saved." + format);
+    QVERIFY(model.saveScene(path));
+
+    // Incremental: uma colocação anda um pixel para lá e para cá, sujando um chunk por save
+    const int handle = model.placements().handles().value(count / 2);
+    int i = 0;
+    QBENCHMARK {
+        if (incremental) {
+            model.movePlacement(handle, model.placements().at(handle).pos() + QPointF(i % 2 ? -1 : 1, 0), false);
+        } else {
+            model.placements().markAllDirty();
+        }
+        QVERIFY(model.saveScene(path));
+        ++i;
+    }
+    model.clear();
+}
+
+void SceneBenchmarks::serializerWrite_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::newRow("sequential/100k") << false;
+    QTest::newRow("parallel/100k") << true;
+}
+
+void SceneBenchmarks::serializerWrite()
+{
+    QFETCH(bool, parallel);
+    SceneModel model(m_entityManager);
+    populate(model, 100000);
+
+    SceneSerializer serializer;
+    model.fillSerializer(serializer);
+    serializer.setParallel(parallel);
+
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY(serializer.writeEsc(&buffer));
+    }
+    model.clear();
+}
+
+// Não é benchmark: .esc -> .escb -> .esc precisa devolver os mesmos bytes, inclusive para
+// cenas do Ethanon com z, ângulo e posições fracionárias
+void SceneBenchmarks::escConversionRoundTrip()
+{
+    SceneSerializer original;
+    original.setParallel(false);
+    const quint32 box = original.internName("box");
+    const quint32 cut = original.internName("cut");
+    original.addRecord(box, 0, 10.5f, -3.25f, 7, 2.0f, 45.0f);
+    original.addRecord(cut, 3, 0.1f, 1024.75f, 8, -0.5f, 359.9f);
+    original.addRecord(box, 1, 4096, 128, 9);
+
+    const QString escPath = m_projectDir.filePath("roundtrip.esc");
+    const QString escbPath = m_projectDir.filePath("roundtrip.escb");
+    const QString backPath = m_projectDir.filePath("roundtrip-back.esc");
+    const QByteArray document = original.toEsc();
+    QVERIFY(writeFile(escPath, document));
+    QVERIFY(document.contains("x=\"10.5\" y=\"-3.25\" z=\"2\" angle=\"45\""));
+
+    QVERIFY(BinarySceneFile::convertEscToEscb(escPath, escbPath));
+    QVERIFY(BinarySceneFile::convertEscbToEsc(escbPath, backPath));
+    QFile back(backPath);
+    QVERIFY(back.open(QIODevice::ReadOnly));
+    QCOMPARE(back.readAll(), document);
+
+    back.seek(0);
+    SceneSerializer reread;
+    QVERIFY(reread.readEsc(&back));
+    QCOMPARE(reread.recordCount(), original.recordCount());
+    for (int i = 0; i < original.recordCount(); ++i) {
+        const SceneSerializer::Record &expected = original.records().at(i);
+        const SceneSerializer::Record &actual = reread.records().at(i);
+        QCOMPARE(actual.id, expected.id);
+        QCOMPARE(actual.x, expected.x);
+        QCOMPARE(actual.y, expected.y);
+        QCOMPARE(actual.z, expected.z);
+        QCOMPARE(actual.angle, expected.angle);
+    }
+}
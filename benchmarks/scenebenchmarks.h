@@ -0,0 +1,77 @@
+#ifndef SCENEBENCHMARKS_H
+#define SCENEBENCHMARKS_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QTemporaryDir>
+
+class Entity;
+class EntityManager;
+class SceneModel;
+
+// Benchmarks dos caminhos quentes do loader, do desenho dos tiles e do I/O de cena.
+//
+// Tudo roda sobre um projeto gerado em initTestCase() num diretório temporário (spritesheet
+// cortado por SpriteCut, atlas TextureAtlas e entidades só de colisão), então os números não
+// dependem dos assets de quem roda. As cenas de 1k/10k/100k colocações também são geradas ali.
+class SceneBenchmarks : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CatalogEntitiesPerKind = 100;
+
+    SceneBenchmarks();
+    ~SceneBenchmarks();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Loader
+    void entityConstruction_data();
+    void entityConstruction();
+    void catalogLoad_data();
+    void catalogLoad();
+
+    // Desenho
+    void createEntityPixmap_data();
+    void createEntityPixmap();
+
+    // Edição
+    void placeEntity_data();
+    void placeEntity();
+    void placementLogging_data();
+    void placementLogging();
+    void eraseEntity_data();
+    void eraseEntity();
+    void undoRedo_data();
+    void undoRedo();
+    void placementQueries_data();
+    void placementQueries();
+
+    // I/O de cena
+    void importScene_data();
+    void importScene();
+    void saveScene_data();
+    void saveScene();
+    void serializerWrite_data();
+    void serializerWrite();
+    void escConversionRoundTrip();
+
+private:
+    QString entitiesPath() const;
+    QString scenePath(int count, const QString &suffix) const;
+    // Colocações em grade, sem histórico; a view não existe, então só a store é atualizada
+    void populate(SceneModel &model, int count) const;
+    static void addSceneSizeRows();
+
+    QTemporaryDir m_projectDir;
+    EntityManager *m_entityManager;
+    Entity *m_cutEntity;
+    Entity *m_atlasEntity;
+    Entity *m_collisionEntity;
+};
+
+#endif // SCENEBENCHMARKS_H
@@ -0,0 +1,247 @@
+#include "asynclogger.h"
+#include <QDateTime>
+#include <QThread>
+
+namespace {
+
+const char *levelTag(AsyncLogger::Level level)
+{
+    switch (level) {
+    case AsyncLogger::Trace:
+        return "T";
+    case AsyncLogger::Debug:
+        return "D";
+    case AsyncLogger::Info:
+        return "I";
+    case AsyncLogger::Warning:
+        return "W";
+    default:
+        return "C";
+    }
+}
+
+AsyncLogger::Level levelFromMsgType(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return AsyncLogger::Debug;
+    case QtInfoMsg:
+        return AsyncLogger::Info;
+    case QtWarningMsg:
+        return AsyncLogger::Warning;
+    default:
+        return AsyncLogger::Critical;
+    }
+}
+
+QtMessageHandler previousHandler = nullptr;
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    const AsyncLogger::Level level = levelFromMsgType(type);
+    if (AsyncLogger::shouldLog(level)) {
+        QString text = message;
+        AsyncLogger::instance().log(level, context.category ? context.category : "default", std::move(text));
+    }
+    // Avisos e erros continuam aparecendo no console; qFatal precisa do handler original para abortar
+    if (level >= AsyncLogger::Warning && previousHandler) {
+        previousHandler(type, context, message);
+    }
+}
+
+}
+
+std::atomic<int> AsyncLogger::s_level(AsyncLogger::Info);
+
+AsyncLogger &AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : m_slots(new Slot[Capacity]),
+      m_enqueuePos(0),
+      m_dequeuePos(0),
+      m_dropped(0),
+      m_written(0),
+      m_reportedDropped(0),
+      m_prefixSecond(-1),
+      m_thread(nullptr),
+      m_running(false)
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "a capacidade do buffer de log precisa ser potência de 2");
+    for (int i = 0; i < Capacity; ++i) {
+        m_slots[i].sequence.store(static_cast<quint64>(i), std::memory_order_relaxed);
+    }
+
+    Level envLevel;
+    if (parseLevel(qEnvironmentVariable("SCENELOG_LEVEL"), &envLevel)) {
+        setLevel(envLevel);
+    }
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+bool AsyncLogger::parseLevel(const QString &name, Level *level)
+{
+    static const char *const names[] = { "trace", "debug", "info", "warning", "critical", "off" };
+    for (int i = 0; i <= Off; ++i) {
+        if (name.compare(QLatin1String(names[i]), Qt::CaseInsensitive) == 0) {
+            *level = static_cast<Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncLogger::installMessageHandler()
+{
+    instance();
+    previousHandler = qInstallMessageHandler(messageHandler);
+}
+
+bool AsyncLogger::start(const QString &path)
+{
+    if (m_thread) {
+        return true;
+    }
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Não foi possível abrir o arquivo de log:" << path;
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = QThread::create([this]() { writerLoop(); });
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+void AsyncLogger::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+    m_running.store(false, std::memory_order_release);
+    m_wakeMutex.lock();
+    m_wake.wakeOne();
+    m_wakeMutex.unlock();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_file.close();
+}
+
+// Fila limitada de Vyukov: cada slot tem um número de sequência que diz de quem é a vez.
+// O produtor reserva a posição com um CAS e publica a mensagem avançando a sequência.
+bool AsyncLogger::log(Level level, const char *category, QString &&text)
+{
+    quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = &m_slots[pos & (Capacity - 1)];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(sequence) - static_cast<qint64>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->message.timestamp = QDateTime::currentMSecsSinceEpoch();
+    slot->message.level = level;
+    slot->message.category = category;
+    slot->message.text = std::move(text);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // Buffer enchendo: acorda a escrita antes do próximo intervalo. Sem o mutex o aviso pode
+    // se perder, mas o timeout do writerLoop cobre
+    if ((pos & (Capacity / 2 - 1)) == 0) {
+        m_wake.wakeOne();
+    }
+    return true;
+}
+
+bool AsyncLogger::tryPop(Message &message)
+{
+    Slot &slot = m_slots[m_dequeuePos & (Capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+        return false;
+    }
+    message = std::move(slot.message);
+    slot.message.text.clear();
+    slot.sequence.store(m_dequeuePos + Capacity, std::memory_order_release);
+    ++m_dequeuePos;
+    return true;
+}
+
+bool AsyncLogger::drain(QByteArray &batch)
+{
+    batch.clear();
+    Message message;
+    quint64 count = 0;
+    while (tryPop(message)) {
+        // A data só é formatada uma vez por segundo; os milissegundos vão direto
+        const qint64 second = message.timestamp / 1000;
+        if (second != m_prefixSecond) {
+            m_prefixSecond = second;
+            m_timestampPrefix = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss.").toUtf8();
+        }
+        const int millis = static_cast<int>(message.timestamp % 1000);
+        batch += m_timestampPrefix;
+        batch += char('0' + millis / 100);
+        batch += char('0' + millis / 10 % 10);
+        batch += char('0' + millis % 10);
+        batch += ' ';
+        batch += levelTag(message.level);
+        batch += ' ';
+        batch += message.category;
+        batch += ": ";
+        batch += message.text.toUtf8();
+        batch += '\n';
+        ++count;
+    }
+
+    const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        batch += QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz ").toUtf8();
+        batch += "W AsyncLogger: " + QByteArray::number(dropped - m_reportedDropped)
+                 + " mensagens descartadas com o buffer cheio\n";
+        m_reportedDropped = dropped;
+    }
+
+    if (batch.isEmpty()) {
+        return false;
+    }
+    m_file.write(batch);
+    m_file.flush();
+    m_written.fetch_add(count, std::memory_order_relaxed);
+    return true;
+}
+
+void AsyncLogger::writerLoop()
+{
+    QByteArray batch;
+    batch.reserve(64 * 1024);
+    while (m_running.load(std::memory_order_acquire)) {
+        // Um lote por intervalo, a não ser que o buffer esteja enchendo
+        drain(batch);
+        m_wakeMutex.lock();
+        if (m_running.load(std::memory_order_acquire)) {
+            m_wake.wait(&m_wakeMutex, FlushIntervalMs);
+        }
+        m_wakeMutex.unlock();
+    }
+    // O que chegou até o stop()
+    drain(batch);
+}
@@ -0,0 +1,142 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+// Nível mínimo compilado: abaixo dele as linhas de log somem do binário (o build de release
+// define SCENELOG_MIN_LEVEL=2 no core.pro e no core.pri, deixando só Info para cima)
+#ifndef SCENELOG_MIN_LEVEL
+#define SCENELOG_MIN_LEVEL 0
+#endif
+
+// Log assíncrono para os caminhos quentes do editor.
+//
+// Quem loga só formata a mensagem e a coloca num ring buffer sem lock (várias threads
+// produzem, uma consome); uma thread de escrita drena o buffer e grava no arquivo em lotes,
+// com um flush por lote. Com o buffer cheio a mensagem é descartada e contada, nunca espera.
+//
+// Os níveis são filtrados duas vezes antes de qualquer formatação: em tempo de compilação
+// por SCENELOG_MIN_LEVEL e em tempo de execução por setLevel() (ou SCENELOG_LEVEL no
+// ambiente). Nível desligado custa um load atômico, ou nada se foi compilado fora.
+//
+//   SCENE_LOG_DEBUG("MainWindow") << "Entidade colocada em" << pos;
+class AsyncLogger
+{
+public:
+    enum Level {
+        Trace = 0,
+        Debug = 1,
+        Info = 2,
+        Warning = 3,
+        Critical = 4,
+        Off = 5
+    };
+
+    // Potência de 2; cerca de meio segundo de log intenso
+    static constexpr int Capacity = 8192;
+    static constexpr int FlushIntervalMs = 100;
+
+    static AsyncLogger &instance();
+
+    ~AsyncLogger();
+
+    // Começa a gravar em path (anexando); as mensagens de antes ficam no buffer até aqui
+    bool start(const QString &path);
+    // Grava o que falta e encerra a thread de escrita
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+
+    static bool shouldLog(Level level)
+    {
+        return level >= SCENELOG_MIN_LEVEL && level >= s_level.load(std::memory_order_relaxed);
+    }
+    static Level level() { return static_cast<Level>(s_level.load(std::memory_order_relaxed)); }
+    static void setLevel(Level level) { s_level.store(level, std::memory_order_relaxed); }
+    static bool parseLevel(const QString &name, Level *level);
+
+    // Também manda as mensagens do qDebug/qCInfo/... para o buffer; Warning e acima
+    // continuam indo também para o handler anterior (o console)
+    static void installMessageHandler();
+
+    // Não bloqueia; false se o buffer estava cheio
+    bool log(Level level, const char *category, QString &&text);
+
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    quint64 writtenCount() const { return m_written.load(std::memory_order_relaxed); }
+
+    // Uma linha de log: a mensagem vai para o buffer quando o temporário é destruído
+    class Record
+    {
+    public:
+        Record(Level level, const char *category) : m_level(level), m_category(category) {}
+        ~Record() { AsyncLogger::instance().log(m_level, m_category, std::move(m_text)); }
+        // O QDebug devolvido é destruído antes do Record, então o texto já está completo aqui
+        QDebug stream() { return QDebug(&m_text); }
+
+    private:
+        Level m_level;
+        const char *m_category;
+        QString m_text;
+    };
+
+private:
+    struct Message
+    {
+        qint64 timestamp;
+        Level level;
+        const char *category;
+        QString text;
+    };
+
+    struct Slot
+    {
+        std::atomic<quint64> sequence;
+        Message message;
+    };
+
+    AsyncLogger();
+    AsyncLogger(const AsyncLogger &) = delete;
+    AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+    bool tryPop(Message &message);
+    void writerLoop();
+    // Drena o buffer para o arquivo num write e um flush; false se não havia nada
+    bool drain(QByteArray &batch);
+
+    static std::atomic<int> s_level;
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<quint64> m_enqueuePos;
+    alignas(64) quint64 m_dequeuePos;   // Só a thread de escrita mexe
+    std::atomic<quint64> m_dropped;
+    std::atomic<quint64> m_written;
+    quint64 m_reportedDropped;
+    qint64 m_prefixSecond;
+    QByteArray m_timestampPrefix;
+
+    QFile m_file;
+    QThread *m_thread;
+    std::atomic<bool> m_running;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wake;
+};
+
+#define SCENE_LOG(level, category) \
+    for (bool sceneLogEnabled = AsyncLogger::shouldLog(level); sceneLogEnabled; sceneLogEnabled = false) \
+        AsyncLogger::Record(level, category).stream()
+
+#define SCENE_LOG_TRACE(category) SCENE_LOG(AsyncLogger::Trace, category)
+#define SCENE_LOG_DEBUG(category) SCENE_LOG(AsyncLogger::Debug, category)
+#define SCENE_LOG_INFO(category) SCENE_LOG(AsyncLogger::Info, category)
+#define SCENE_LOG_WARNING(category) SCENE_LOG(AsyncLogger::Warning, category)
+
+#endif // ASYNCLOGGER_H
@@ -0,0 +1,361 @@
+#include "binaryscenefile.h"
+#include "sceneserializer.h"
+#include <QDebug>
+#include <QSaveFile>
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char kEscbMagic[8] = { 'E', 'T', 'H', 'S', 'C', 'N', 'B', '1' };
+const quint32 kEscbVersion = 1;
+
+}
+
+struct BinarySceneFile::EscbHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 nameCount;
+    quint32 chunkCount;
+    quint32 recordCount;
+    quint32 stringBytes;
+    float chunkSize;
+    quint64 reserved;
+};
+
+struct BinarySceneFile::EscbName
+{
+    quint32 offset;
+    quint32 length;
+};
+
+BinarySceneFile::BinarySceneFile()
+    : m_data(nullptr),
+      m_size(0)
+{
+    // O arquivo é lido direto do mapeamento, então o layout não pode mudar sem trocar a versão
+    static_assert(sizeof(EscbHeader) == 40, "layout do cabeçalho mudou");
+    static_assert(sizeof(EscbName) == 8, "layout do nome mudou");
+    static_assert(sizeof(EscbChunk) == 32, "layout do chunk mudou");
+    static_assert(sizeof(EscbRecord) == 40, "layout do registro mudou");
+}
+
+BinarySceneFile::~BinarySceneFile()
+{
+    close();
+}
+
+bool BinarySceneFile::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Não foi possível abrir a cena binária:" << path;
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(EscbHeader))) {
+        qWarning() << "Cena binária truncada:" << path;
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        qWarning() << "Falha ao mapear a cena binária:" << path;
+        close();
+        return false;
+    }
+
+    const EscbHeader *h = header();
+    if (std::memcmp(h->magic, kEscbMagic, sizeof(kEscbMagic)) != 0 || h->version != kEscbVersion) {
+        qWarning() << "Cena binária com formato desconhecido:" << path;
+        close();
+        return false;
+    }
+
+    qint64 expectedSize = static_cast<qint64>(sizeof(EscbHeader))
+                          + static_cast<qint64>(h->nameCount) * sizeof(EscbName)
+                          + static_cast<qint64>(h->chunkCount) * sizeof(EscbChunk)
+                          + static_cast<qint64>(h->recordCount) * sizeof(EscbRecord)
+                          + h->stringBytes;
+    if (expectedSize != m_size) {
+        qWarning() << "Cena binária inconsistente:" << m_size << "bytes, esperado" << expectedSize;
+        close();
+        return false;
+    }
+
+    qDebug() << "Cena binária mapeada:" << path << "-" << h->recordCount << "registros em"
+             << h->chunkCount << "chunks";
+    return true;
+}
+
+void BinarySceneFile::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+}
+
+int BinarySceneFile::recordCount() const
+{
+    return m_data ? static_cast<int>(header()->recordCount) : 0;
+}
+
+int BinarySceneFile::nameCount() const
+{
+    return m_data ? static_cast<int>(header()->nameCount) : 0;
+}
+
+int BinarySceneFile::chunkCount() const
+{
+    return m_data ? static_cast<int>(header()->chunkCount) : 0;
+}
+
+float BinarySceneFile::chunkSize() const
+{
+    return m_data ? header()->chunkSize : DefaultChunkSize;
+}
+
+QString BinarySceneFile::nameAt(int index) const
+{
+    if (!m_data || index < 0 || index >= nameCount()) {
+        return QString();
+    }
+    const EscbName &name = names()[index];
+    if (static_cast<quint64>(name.offset) + name.length > header()->stringBytes) {
+        return QString();
+    }
+    return QString::fromUtf8(strings() + name.offset, static_cast<int>(name.length));
+}
+
+const BinarySceneFile::EscbHeader *BinarySceneFile::header() const
+{
+    return reinterpret_cast<const EscbHeader*>(m_data);
+}
+
+const BinarySceneFile::EscbName *BinarySceneFile::names() const
+{
+    return reinterpret_cast<const EscbName*>(m_data + sizeof(EscbHeader));
+}
+
+const BinarySceneFile::EscbChunk *BinarySceneFile::chunks() const
+{
+    return reinterpret_cast<const EscbChunk*>(names() + header()->nameCount);
+}
+
+const BinarySceneFile::EscbRecord *BinarySceneFile::records() const
+{
+    return reinterpret_cast<const EscbRecord*>(chunks() + header()->chunkCount);
+}
+
+const char *BinarySceneFile::strings() const
+{
+    return reinterpret_cast<const char*>(records() + header()->recordCount);
+}
+
+QVector<quint32> BinarySceneFile::recordsInSequence() const
+{
+    const quint32 count = static_cast<quint32>(recordCount());
+    const EscbRecord *recordTable = records();
+
+    // Caso normal: sequence é uma permutação de 0..count-1
+    QVector<quint32> order(static_cast<int>(count), count);
+    bool isPermutation = true;
+    for (quint32 i = 0; i < count; ++i) {
+        const quint32 sequence = recordTable[i].sequence;
+        if (sequence >= count || order[static_cast<int>(sequence)] != count) {
+            isPermutation = false;
+            break;
+        }
+        order[static_cast<int>(sequence)] = i;
+    }
+
+    if (!isPermutation) {
+        for (quint32 i = 0; i < count; ++i) {
+            order[static_cast<int>(i)] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [recordTable](quint32 a, quint32 b) {
+            return recordTable[a].sequence < recordTable[b].sequence;
+        });
+    }
+    return order;
+}
+
+void BinarySceneFile::toSerializer(SceneSerializer &scene) const
+{
+    scene.clear();
+    if (!m_data) {
+        return;
+    }
+
+    QVector<quint32> nameMap(nameCount());
+    for (int i = 0; i < nameCount(); ++i) {
+        nameMap[i] = scene.internName(nameAt(i));
+    }
+
+    const EscbRecord *recordTable = records();
+    const QVector<quint32> order = recordsInSequence();
+    scene.reserve(order.size());
+    for (quint32 index : order) {
+        const EscbRecord &record = recordTable[index];
+        if (record.nameIndex >= static_cast<quint32>(nameMap.size())) {
+            qWarning() << "Registro com nome inválido na cena binária:" << record.nameIndex;
+            continue;
+        }
+        scene.addRecord(nameMap[static_cast<int>(record.nameIndex)], record.spriteFrame,
+                        record.x, record.y, record.id, record.z, record.angle);
+    }
+}
+
+bool BinarySceneFile::write(const QString &path, const SceneSerializer &scene, float chunkSize)
+{
+    if (chunkSize <= 0) {
+        chunkSize = DefaultChunkSize;
+    }
+
+    const QVector<SceneSerializer::Record> &sceneRecords = scene.records();
+    const int count = sceneRecords.size();
+
+    // Chunk de cada registro pela posição; agrupados por (linha, coluna) mantendo a ordem do .esc
+    QVector<qint32> columns(count);
+    QVector<qint32> rows(count);
+    QVector<quint32> order(count);
+    for (int i = 0; i < count; ++i) {
+        columns[i] = qFloor(sceneRecords[i].x / chunkSize);
+        rows[i] = qFloor(sceneRecords[i].y / chunkSize);
+        order[i] = static_cast<quint32>(i);
+    }
+    std::sort(order.begin(), order.end(), [&](quint32 a, quint32 b) {
+        if (rows[a] != rows[b]) {
+            return rows[a] < rows[b];
+        }
+        if (columns[a] != columns[b]) {
+            return columns[a] < columns[b];
+        }
+        return a < b;
+    });
+
+    QVector<EscbRecord> recordTable;
+    QVector<EscbChunk> chunkTable;
+    recordTable.reserve(count);
+    for (quint32 index : order) {
+        const SceneSerializer::Record &source = sceneRecords[static_cast<int>(index)];
+
+        EscbRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.nameIndex = source.nameIndex;
+        record.spriteFrame = source.spriteFrame;
+        record.sequence = index;
+        record.x = source.x;
+        record.y = source.y;
+        record.z = source.z;
+        record.angle = source.angle;
+        record.id = source.id;
+
+        if (chunkTable.isEmpty() || chunkTable.last().column != columns[static_cast<int>(index)]
+            || chunkTable.last().row != rows[static_cast<int>(index)]) {
+            EscbChunk chunk;
+            chunk.column = columns[static_cast<int>(index)];
+            chunk.row = rows[static_cast<int>(index)];
+            chunk.firstRecord = static_cast<quint32>(recordTable.size());
+            chunk.recordCount = 0;
+            chunk.left = chunk.right = record.x;
+            chunk.top = chunk.bottom = record.y;
+            chunkTable.append(chunk);
+        }
+        EscbChunk &chunk = chunkTable.last();
+        ++chunk.recordCount;
+        chunk.left = qMin(chunk.left, record.x);
+        chunk.top = qMin(chunk.top, record.y);
+        chunk.right = qMax(chunk.right, record.x);
+        chunk.bottom = qMax(chunk.bottom, record.y);
+
+        recordTable.append(record);
+    }
+
+    QByteArray stringPool;
+    QVector<EscbName> nameTable;
+    nameTable.reserve(scene.nameCount());
+    for (int i = 0; i < scene.nameCount(); ++i) {
+        const QByteArray utf8 = scene.entityName(static_cast<quint32>(i)).toUtf8();
+        nameTable.append({ static_cast<quint32>(stringPool.size()), static_cast<quint32>(utf8.size()) });
+        stringPool.append(utf8);
+    }
+
+    EscbHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kEscbMagic, sizeof(kEscbMagic));
+    h.version = kEscbVersion;
+    h.nameCount = static_cast<quint32>(nameTable.size());
+    h.chunkCount = static_cast<quint32>(chunkTable.size());
+    h.recordCount = static_cast<quint32>(recordTable.size());
+    h.stringBytes = static_cast<quint32>(stringPool.size());
+    h.chunkSize = chunkSize;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar a cena binária:" << path;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    file.write(reinterpret_cast<const char*>(nameTable.constData()), nameTable.size() * sizeof(EscbName));
+    file.write(reinterpret_cast<const char*>(chunkTable.constData()), chunkTable.size() * sizeof(EscbChunk));
+    file.write(reinterpret_cast<const char*>(recordTable.constData()), recordTable.size() * sizeof(EscbRecord));
+    file.write(stringPool);
+    if (!file.commit()) {
+        qWarning() << "Falha ao gravar a cena binária:" << path << "-" << file.errorString();
+        return false;
+    }
+
+    qDebug() << "Cena binária gravada:" << path << "-" << recordTable.size() << "registros em"
+             << chunkTable.size() << "chunks";
+    return true;
+}
+
+bool BinarySceneFile::convertEscToEscb(const QString &escPath, const QString &escbPath)
+{
+    QFile input(escPath);
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Não foi possível abrir a cena:" << escPath;
+        return false;
+    }
+
+    SceneSerializer scene;
+    if (!scene.readEsc(&input)) {
+        return false;
+    }
+    return write(escbPath, scene);
+}
+
+bool BinarySceneFile::convertEscbToEsc(const QString &escbPath, const QString &escPath)
+{
+    BinarySceneFile binary;
+    if (!binary.open(escbPath)) {
+        return false;
+    }
+
+    SceneSerializer scene;
+    binary.toSerializer(scene);
+
+    QSaveFile output(escPath);
+    // Sem Text: \n em todas as plataformas, como o saveScene
+    if (!output.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar a cena:" << escPath;
+        return false;
+    }
+    if (!scene.writeEsc(&output) || !output.commit()) {
+        qWarning() << "Falha ao gravar a cena:" << escPath << "-" << output.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef BINARYSCENEFILE_H
+#define BINARYSCENEFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+class SceneSerializer;
+
+// Formato binário de cena (.escb), irmão do .esc.
+//
+// Layout fixo, lido via mmap sem nenhuma alocação por registro:
+//
+//   EscbHeader | EscbName[nameCount] | EscbChunk[chunkCount] | EscbRecord[recordCount] | strings UTF-8
+//
+// Os registros ficam agrupados por chunk espacial (células de chunkSize pixels, pela posição)
+// e o diretório de chunks diz onde começa cada grupo e o retângulo que ele cobre. A ordem do
+// .esc é preservada em EscbRecord::sequence, então a conversão .esc -> .escb -> .esc devolve
+// os mesmos bytes. O .esc continua sendo o formato de intercâmbio com o runtime do Ethanon.
+class BinarySceneFile
+{
+public:
+    struct EscbRecord
+    {
+        quint64 id;         // Atributo id do .esc; 0 = sequence + 1
+        quint32 nameIndex;
+        qint32 spriteFrame;
+        quint32 sequence;   // Posição do registro no .esc
+        float x;            // Centro, como gravado no .esc
+        float y;
+        float z;
+        float angle;
+        quint32 reserved;
+    };
+
+    struct EscbChunk
+    {
+        qint32 column;
+        qint32 row;
+        quint32 firstRecord;
+        quint32 recordCount;
+        float left;         // Retângulo que contém as posições do chunk
+        float top;
+        float right;
+        float bottom;
+    };
+
+    static constexpr float DefaultChunkSize = 1024.0f;
+
+    BinarySceneFile();
+    ~BinarySceneFile();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    int recordCount() const;
+    int nameCount() const;
+    int chunkCount() const;
+    float chunkSize() const;
+    QString nameAt(int index) const;
+
+    // Ponteiros para dentro do mapeamento; válidos até close()
+    const EscbRecord *records() const;
+    const EscbChunk *chunks() const;
+
+    // Registros do mapeamento na ordem do .esc (índices para records())
+    QVector<quint32> recordsInSequence() const;
+    // Preenche o serializador com nomes e registros, na ordem do .esc
+    void toSerializer(SceneSerializer &scene) const;
+
+    static bool write(const QString &path, const SceneSerializer &scene, float chunkSize = DefaultChunkSize);
+
+    static bool convertEscToEscb(const QString &escPath, const QString &escbPath);
+    static bool convertEscbToEsc(const QString &escbPath, const QString &escPath);
+
+private:
+    struct EscbHeader;
+    struct EscbName;
+
+    const EscbHeader *header() const;
+    const EscbName *names() const;
+    const char *strings() const;
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+};
+
+#endif // BINARYSCENEFILE_H
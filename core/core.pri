@@ -0,0 +1,19 @@
+# Incluído por quem linka o core (app, tools): headers e libscenecore.a do build do core
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+QT += core gui concurrent
+
+# Mesmo nível mínimo do AsyncLogger que o core.pro, para quem usa os macros SCENE_LOG_*
+CONFIG(release, debug|release): DEFINES += SCENELOG_MIN_LEVEL=2
+
+CORE_BUILD_DIR = $$shadowed($$PWD)
+win32 {
+    CONFIG(debug, debug|release): CORE_BUILD_DIR = $$CORE_BUILD_DIR/debug
+    else: CORE_BUILD_DIR = $$CORE_BUILD_DIR/release
+}
+
+LIBS += -L$$CORE_BUILD_DIR -lscenecore
+
+win32-msvc*: PRE_TARGETDEPS += $$CORE_BUILD_DIR/scenecore.lib
+else: PRE_TARGETDEPS += $$CORE_BUILD_DIR/libscenecore.a
@@ -0,0 +1,47 @@
+TEMPLATE = lib
+TARGET = scenecore
+
+QT = core gui concurrent
+
+CONFIG += staticlib c++17
+
+# Em release as linhas Trace e Debug do AsyncLogger não são compiladas (igual no core.pri)
+CONFIG(release, debug|release): DEFINES += SCENELOG_MIN_LEVEL=2
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    asynclogger.cpp \
+    binaryscenefile.cpp \
+    editjournal.cpp \
+    entity.cpp \
+    entitycatalogcache.cpp \
+    entitymanager.cpp \
+    incrementalscenesaver.cpp \
+    latencyhistogram.cpp \
+    placementstore.cpp \
+    scenemodel.cpp \
+    sceneserializer.cpp \
+    spritesheetcache.cpp \
+    stallwatchdog.cpp \
+    tracerecorder.cpp \
+    undohistory.cpp
+
+HEADERS += \
+    asynclogger.h \
+    binaryscenefile.h \
+    editjournal.h \
+    entity.h \
+    entitycatalogcache.h \
+    entitymanager.h \
+    incrementalscenesaver.h \
+    latencyhistogram.h \
+    placementstore.h \
+    scenemodel.h \
+    sceneserializer.h \
+    spritesheetcache.h \
+    stallwatchdog.h \
+    tracerecorder.h \
+    undohistory.h
@@ -0,0 +1,442 @@
+#include "editjournal.h"
+#include "entity.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kJournalMagic[8] = { 'E', 'T', 'H', 'J', 'R', 'N', 'L', '1' };
+const quint32 kJournalVersion = 1;
+
+// Tipos além de UndoAction::Type (ADD, REMOVE, MOVE)
+enum MarkerType : quint32 {
+    StepBeginMarker = 16,
+    StepEndMarker = 17,
+    NameMarker = 18         // Nome de entidade; os bytes UTF-8 vêm logo depois do registro
+};
+
+// FNV-1a 32 bits, continuando de um hash anterior
+quint32 fnv1a(const void *data, int size, quint32 hash = 2166136261u)
+{
+    const uchar *bytes = static_cast<const uchar*>(data);
+    for (int i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+}
+
+struct EditJournal::JournalHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 scenePathBytes;     // Caminhos em UTF-8 logo depois do cabeçalho
+    quint32 projectPathBytes;
+    quint32 reserved;
+};
+
+struct EditJournal::JournalRecord
+{
+    quint32 type;
+    quint32 nameIndex;
+    quint64 placementId;
+    float oldX;
+    float oldY;
+    float newX;
+    float newY;
+    qint32 tileIndex;       // Em NameMarker, o tamanho do nome
+    quint32 checksum;       // Dos bytes anteriores e do nome que segue
+};
+
+EditJournal::EditJournal()
+    : m_unsynced(false),
+      m_stepDepth(0),
+      m_recordCount(0),
+      m_writerThread(nullptr),
+      m_syncRequested(false),
+      m_writerBusy(false),
+      m_writerStop(false),
+      m_writeFailed(false)
+{
+    static_assert(sizeof(JournalHeader) == 24, "layout do cabeçalho do journal mudou");
+    static_assert(sizeof(JournalRecord) == 40, "layout do registro do journal mudou");
+}
+
+EditJournal::~EditJournal()
+{
+    // Sem stop(true) o journal fica no disco, como depois de um crash
+    stop(false);
+}
+
+bool EditJournal::start(const QString &journalPath, const QString &scenePath, const QString &projectPath)
+{
+    stop(true);
+
+    QDir().mkpath(QFileInfo(journalPath).absolutePath());
+    m_file.setFileName(journalPath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Não foi possível criar o journal de edições:" << journalPath;
+        return false;
+    }
+    m_path = journalPath;
+    m_writeFailed.store(false, std::memory_order_relaxed);
+    m_writerStop = false;
+    m_writerThread = QThread::create([this]() { writerLoop(); });
+    m_writerThread->setObjectName("EditJournal");
+    m_writerThread->start();
+
+    const QByteArray scene = scenePath.toUtf8();
+    const QByteArray project = projectPath.toUtf8();
+    JournalHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+    header.version = kJournalVersion;
+    header.scenePathBytes = static_cast<quint32>(scene.size());
+    header.projectPathBytes = static_cast<quint32>(project.size());
+    m_buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_buffer.append(scene);
+    m_buffer.append(project);
+    m_unsynced = true;
+    // Só o cabeçalho espera o disco: sem ele o journal não serve para nada
+    if (!flush() || !waitForFlush()) {
+        stop(true);
+        return false;
+    }
+
+    // A sessão aponta para o journal até o fechamento limpo
+    QFile session(sessionFilePath());
+    QDir().mkpath(QFileInfo(session.fileName()).absolutePath());
+    if (session.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        session.write(QFileInfo(journalPath).absoluteFilePath().toUtf8());
+    }
+
+    qDebug() << "Journal de edições iniciado:" << journalPath;
+    return true;
+}
+
+void EditJournal::stop(bool removeFile)
+{
+    if (isActive()) {
+        flush();
+        m_writerMutex.lock();
+        m_writerStop = true;
+        m_writerWake.wakeOne();
+        m_writerMutex.unlock();
+        m_writerThread->wait();
+        delete m_writerThread;
+        m_writerThread = nullptr;
+
+        m_file.close();
+        if (removeFile) {
+            m_file.remove();
+            QFile::remove(sessionFilePath());
+        }
+    }
+    m_buffer.clear();
+    m_unsynced = false;
+    m_entityIndex.clear();
+    m_stepDepth = 0;
+    m_recordCount = 0;
+}
+
+void EditJournal::beginStep()
+{
+    if (isActive() && m_stepDepth++ == 0) {
+        JournalRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.type = StepBeginMarker;
+        appendRecord(record);
+    }
+}
+
+void EditJournal::endStep()
+{
+    if (!isActive() || m_stepDepth == 0) {
+        return;
+    }
+    if (--m_stepDepth == 0) {
+        JournalRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.type = StepEndMarker;
+        appendRecord(record);
+    }
+}
+
+void EditJournal::record(const UndoAction &action)
+{
+    if (!isActive() || !action.entity) {
+        return;
+    }
+
+    JournalRecord record;
+    record.type = static_cast<quint32>(action.type);
+    record.nameIndex = internEntity(action.entity);
+    record.placementId = action.placementId;
+    record.oldX = static_cast<float>(action.oldPos.x());
+    record.oldY = static_cast<float>(action.oldPos.y());
+    record.newX = static_cast<float>(action.newPos.x());
+    record.newY = static_cast<float>(action.newPos.y());
+    record.tileIndex = action.tileIndex;
+    appendRecord(record);
+}
+
+quint32 EditJournal::internEntity(Entity *entity)
+{
+    auto it = m_entityIndex.constFind(entity);
+    if (it != m_entityIndex.constEnd()) {
+        return it.value();
+    }
+
+    const quint32 index = static_cast<quint32>(m_entityIndex.size());
+    const QByteArray name = entity->getName().toUtf8();
+    JournalRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.type = NameMarker;
+    record.nameIndex = index;
+    record.tileIndex = name.size();
+    appendRecord(record, name);
+    m_entityIndex.insert(entity, index);
+    return index;
+}
+
+void EditJournal::appendRecord(JournalRecord &record, const QByteArray &payload)
+{
+    record.checksum = fnv1a(&record, offsetof(JournalRecord, checksum));
+    if (!payload.isEmpty()) {
+        record.checksum = fnv1a(payload.constData(), payload.size(), record.checksum);
+    }
+    m_buffer.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    m_buffer.append(payload);
+    ++m_recordCount;
+    m_unsynced = true;
+
+    // O fsync fica para o flush() periódico; aqui só não deixa o buffer crescer sem limite
+    if (m_buffer.size() >= WriteThresholdBytes) {
+        submitBuffer(false);
+    }
+}
+
+void EditJournal::submitBuffer(bool sync)
+{
+    QMutexLocker locker(&m_writerMutex);
+    if (m_writeQueue.isEmpty()) {
+        m_writeQueue.swap(m_buffer);
+    } else {
+        m_writeQueue.append(m_buffer);
+        m_buffer.clear();
+    }
+    m_syncRequested = m_syncRequested || sync;
+    m_writerWake.wakeOne();
+}
+
+bool EditJournal::flush()
+{
+    if (!isActive()) {
+        return false;
+    }
+    if (m_unsynced) {
+        submitBuffer(true);
+        m_unsynced = false;
+    }
+    return !m_writeFailed.load(std::memory_order_relaxed);
+}
+
+bool EditJournal::waitForFlush()
+{
+    if (!isActive()) {
+        return false;
+    }
+    QMutexLocker locker(&m_writerMutex);
+    while (!m_writeQueue.isEmpty() || m_syncRequested || m_writerBusy) {
+        m_writerIdle.wait(&m_writerMutex);
+    }
+    return !m_writeFailed.load(std::memory_order_relaxed);
+}
+
+// Um lote por volta: tudo o que chegou desde a última gravação, com um fsync se foi pedido
+void EditJournal::writerLoop()
+{
+    QByteArray batch;
+    QMutexLocker locker(&m_writerMutex);
+    for (;;) {
+        while (!m_writerStop && m_writeQueue.isEmpty() && !m_syncRequested) {
+            m_writerWake.wait(&m_writerMutex);
+        }
+        if (m_writeQueue.isEmpty() && !m_syncRequested) {
+            break;
+        }
+        batch.swap(m_writeQueue);
+        const bool sync = m_syncRequested;
+        m_syncRequested = false;
+        m_writerBusy = true;
+        locker.unlock();
+
+        bool ok = batch.isEmpty() || m_file.write(batch) == batch.size();
+        batch.clear();
+        if (ok && sync) {
+            ok = m_file.flush();
+#if defined(Q_OS_WIN)
+            ok = ok && _commit(m_file.handle()) == 0;
+#elif defined(Q_OS_LINUX)
+            ok = ok && ::fdatasync(m_file.handle()) == 0;
+#else
+            ok = ok && ::fsync(m_file.handle()) == 0;
+#endif
+        }
+        if (!ok) {
+            qWarning() << "Falha ao gravar o journal de edições:" << m_file.errorString();
+            m_writeFailed.store(true, std::memory_order_relaxed);
+        }
+
+        locker.relock();
+        m_writerBusy = false;
+        m_writerIdle.wakeAll();
+    }
+    m_writerIdle.wakeAll();
+}
+
+QString EditJournal::journalPathFor(const QString &scenePath)
+{
+    if (scenePath.isEmpty()) {
+        return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("untitled.journal");
+    }
+    return scenePath + ".journal";
+}
+
+QString EditJournal::sessionFilePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("journal.session");
+}
+
+QString EditJournal::abandonedJournalPath()
+{
+    QFile session(sessionFilePath());
+    if (!session.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QString journalPath = QString::fromUtf8(session.readAll()).trimmed();
+    return QFileInfo::exists(journalPath) ? journalPath : QString();
+}
+
+bool EditJournal::read(const QString &journalPath, Contents &contents)
+{
+    contents = Contents{QString(), QString(), QVector<QString>(), QVector<Entry>(), 0, false};
+
+    QFile file(journalPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size < static_cast<qint64>(sizeof(JournalHeader))) {
+        return false;
+    }
+    const uchar *data = file.map(0, size);
+    if (!data) {
+        return false;
+    }
+
+    JournalHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    qint64 offset = sizeof(header) + static_cast<qint64>(header.scenePathBytes) + header.projectPathBytes;
+    if (std::memcmp(header.magic, kJournalMagic, sizeof(kJournalMagic)) != 0
+        || header.version != kJournalVersion || offset > size) {
+        qWarning() << "Journal de edições com formato desconhecido:" << journalPath;
+        file.unmap(const_cast<uchar*>(data));
+        return false;
+    }
+    const char *text = reinterpret_cast<const char*>(data + sizeof(header));
+    contents.scenePath = QString::fromUtf8(text, static_cast<int>(header.scenePathBytes));
+    contents.projectPath = QString::fromUtf8(text + header.scenePathBytes, static_cast<int>(header.projectPathBytes));
+
+    // Passo em andamento: só entra em entries quando o marcador de fim aparece
+    QVector<Entry> openStep;
+    bool inStep = false;
+
+    while (offset < size) {
+        if (size - offset < static_cast<qint64>(sizeof(JournalRecord))) {
+            contents.truncated = true;
+            break;
+        }
+        JournalRecord record;
+        std::memcpy(&record, data + offset, sizeof(record));
+        offset += sizeof(record);
+
+        quint32 checksum = fnv1a(&record, offsetof(JournalRecord, checksum));
+        if (record.type == NameMarker) {
+            if (record.tileIndex < 0 || size - offset < record.tileIndex) {
+                contents.truncated = true;
+                break;
+            }
+            checksum = fnv1a(data + offset, record.tileIndex, checksum);
+        }
+        if (checksum != record.checksum) {
+            contents.truncated = true;
+            break;
+        }
+
+        switch (record.type) {
+        case NameMarker:
+            if (record.nameIndex != static_cast<quint32>(contents.entityNames.size())) {
+                contents.truncated = true;
+                offset = size;
+                break;
+            }
+            contents.entityNames.append(QString::fromUtf8(reinterpret_cast<const char*>(data + offset), record.tileIndex));
+            offset += record.tileIndex;
+            break;
+        case StepBeginMarker:
+            openStep.clear();
+            inStep = true;
+            break;
+        case StepEndMarker:
+            if (inStep) {
+                contents.entries += openStep;
+                ++contents.stepCount;
+            }
+            openStep.clear();
+            inStep = false;
+            break;
+        case UndoAction::ADD:
+        case UndoAction::REMOVE:
+        case UndoAction::MOVE: {
+            Entry entry;
+            entry.type = static_cast<UndoAction::Type>(record.type);
+            entry.nameIndex = record.nameIndex;
+            entry.tileIndex = record.tileIndex;
+            entry.oldPos = QPointF(record.oldX, record.oldY);
+            entry.newPos = QPointF(record.newX, record.newY);
+            entry.placementId = record.placementId;
+            if (inStep) {
+                openStep.append(entry);
+            } else {
+                contents.entries.append(entry);
+                ++contents.stepCount;
+            }
+            break;
+        }
+        default:
+            contents.truncated = true;
+            offset = size;
+            break;
+        }
+    }
+
+    if (inStep) {
+        contents.truncated = true;
+    }
+    file.unmap(const_cast<uchar*>(data));
+    return true;
+}
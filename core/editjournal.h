@@ -0,0 +1,114 @@
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include "undohistory.h"
+
+class Entity;
+class QThread;
+
+// Journal de edições (write-ahead) para recuperar a cena depois de um crash.
+//
+// Cada mudança aplicada à cena (ADD/REMOVE/MOVE, inclusive as de undo/redo) vira um registro
+// de 40 bytes com checksum, anexado a um buffer em memória. flush() entrega o buffer a uma
+// thread de escrita, que grava e faz um único fsync; sem nada novo desde o último flush() ele
+// volta sem fazer nada, então quem usa pode chamá-lo periodicamente da thread da interface.
+// Passos compostos ficam entre marcadores de início e fim e são reaplicados inteiros ou não são.
+//
+// O journal fica ao lado da cena (cena.esc.journal) e guarda o caminho da cena e do projeto
+// sobre os quais as edições valem. Um arquivo de sessão aponta para o journal ativo; se ele
+// ainda existe ao abrir o editor, o último fechamento não foi limpo.
+class EditJournal
+{
+public:
+    struct Entry
+    {
+        UndoAction::Type type;
+        quint32 nameIndex;
+        qint32 tileIndex;
+        QPointF oldPos;
+        QPointF newPos;
+        quint64 placementId;
+    };
+
+    // Conteúdo válido de um journal, só com passos completos
+    struct Contents
+    {
+        QString scenePath;
+        QString projectPath;
+        QVector<QString> entityNames;
+        QVector<Entry> entries;
+        int stepCount;
+        bool truncated;     // O fim do arquivo tinha um registro cortado ou um passo incompleto
+    };
+
+    // Acima disso o buffer é gravado (sem fsync) já na própria edição
+    static constexpr int WriteThresholdBytes = 64 * 1024;
+    static constexpr int DefaultFlushIntervalMs = 250;
+
+    EditJournal();
+    ~EditJournal();
+
+    // Começa um journal vazio em journalPath (apaga o anterior, se houver)
+    bool start(const QString &journalPath, const QString &scenePath, const QString &projectPath);
+    // Fechamento limpo: grava o que falta e, com removeFile, apaga o journal e a sessão
+    void stop(bool removeFile);
+    bool isActive() const { return m_writerThread != nullptr; }
+    QString path() const { return m_path; }
+
+    void beginStep();
+    void endStep();
+    void record(const UndoAction &action);
+
+    // Não bloqueia; false se uma gravação anterior falhou
+    bool flush();
+    // Espera a thread de escrita gravar e sincronizar tudo o que já foi entregue
+    bool waitForFlush();
+    int pendingBytes() const { return m_buffer.size(); }
+    qint64 recordCount() const { return m_recordCount; }
+
+    static QString journalPathFor(const QString &scenePath);
+    // Journal deixado por uma sessão que não fechou direito, ou vazio
+    static QString abandonedJournalPath();
+    static bool read(const QString &journalPath, Contents &contents);
+
+private:
+    struct JournalHeader;
+    struct JournalRecord;
+
+    quint32 internEntity(Entity *entity);
+    void appendRecord(JournalRecord &record, const QByteArray &payload = QByteArray());
+    // Passa o buffer para a thread de escrita, pedindo ou não o fsync
+    void submitBuffer(bool sync);
+    void writerLoop();
+    static QString sessionFilePath();
+
+    QString m_path;
+    QByteArray m_buffer;
+    bool m_unsynced;        // Houve registro desde o último flush()
+    QHash<Entity*, quint32> m_entityIndex;
+    int m_stepDepth;
+    qint64 m_recordCount;
+
+    // Só a thread de escrita mexe no arquivo enquanto ela está rodando
+    QFile m_file;
+    QThread *m_writerThread;
+    QMutex m_writerMutex;
+    QWaitCondition m_writerWake;
+    QWaitCondition m_writerIdle;
+    QByteArray m_writeQueue;
+    bool m_syncRequested;
+    bool m_writerBusy;
+    bool m_writerStop;
+    std::atomic<bool> m_writeFailed;
+};
+
+#endif // EDITJOURNAL_H
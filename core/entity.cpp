@@ -0,0 +1,331 @@
+#include "entity.h"
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QDebug>
+#include <QFileInfo>
+#include <QDir>
+#include <QPainter>
+#include <QImageReader>
+#include "asynclogger.h"
+#include "spritesheetcache.h"
+
+Entity::Entity(const QString &name, const QString &filePath)
+    : Entity(loadDefinition(name, filePath))
+{
+}
+
+Entity::Entity(const EntityDefinition &definition, SpritesheetCache *cache)
+    : m_type(definition.type),
+      m_name(definition.name),
+      m_imagePath(definition.imagePath),
+      m_imageSize(definition.imagePath.isEmpty() ? QSize(0, 0) : definition.imageSize),
+      m_cache(cache),
+      m_placementRefs(0),
+      m_selectedTileIndex(0),
+      m_isInvisible(definition.isInvisible),
+      m_hasSprite(definition.hasSprite),
+      m_collisionSize(definition.collisionSize)
+{
+    // Só metadados: a imagem é decodificada sob demanda em getPixmap()
+    m_spriteDefinitions = definition.spriteDefinitions;
+}
+
+Entity::~Entity()
+{
+    if (m_cache) {
+        m_cache->remove(this);
+    }
+}
+
+QPixmap Entity::getPixmap() const
+{
+    if (m_pixmap.isNull() && !m_imagePath.isEmpty()) {
+        QImage image;
+        if (m_hasSprite && !image.load(m_imagePath)) {
+            qWarning() << "Falha ao decodificar imagem:" << m_imagePath;
+        }
+        if (image.isNull()) {
+            image = renderPlaceholderImage(m_name, m_imageSize);
+        }
+        m_pixmap = QPixmap::fromImage(image);
+        SCENE_LOG_DEBUG("Entity") << "Spritesheet decodificado:" << m_name << "-" << decodedBytes() << "bytes";
+        if (m_cache) {
+            m_cache->insert(this, decodedBytes());
+        }
+    } else if (m_cache && !m_pixmap.isNull()) {
+        m_cache->touch(this);
+    }
+    return m_pixmap;
+}
+
+qint64 Entity::decodedBytes() const
+{
+    if (m_pixmap.isNull()) {
+        return 0;
+    }
+    return static_cast<qint64>(m_pixmap.width()) * m_pixmap.height() * m_pixmap.depth() / 8;
+}
+
+void Entity::releaseDecodedImage() const
+{
+    m_pixmap = QPixmap();
+}
+
+QImage Entity::renderPlaceholderImage(const QString &name, const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setPen(Qt::red);
+    painter.drawRect(0, 0, size.width() - 1, size.height() - 1);
+    painter.drawText(image.rect(), Qt::AlignCenter, name);
+    return image;
+}
+
+EntityDefinition Entity::loadDefinition(const QString &name, const QString &filePath)
+{
+    EntityDefinition definition;
+    definition.name = name;
+    definition.filePath = filePath;
+
+    SCENE_LOG_DEBUG("Entity") << "Iniciando carregamento da entidade:" << name;
+
+    if (name.isEmpty() || filePath.isEmpty()) {
+        qWarning() << "Nome ou caminho do arquivo vazio para a entidade";
+        return definition;
+    }
+
+    loadEntityDefinition(definition);
+
+    SCENE_LOG_DEBUG("Entity") << "Carregamento da entidade concluído:" << name;
+    return definition;
+}
+
+bool Entity::loadImage(EntityDefinition &definition, const QString &imageName)
+{
+    QFileInfo fileInfo(definition.filePath);
+    definition.imagePath = fileInfo.dir().filePath(imageName);
+    return loadImageInfo(definition);
+}
+
+bool Entity::loadImageInfo(EntityDefinition &definition)
+{
+    const QString &imagePath = definition.imagePath;
+
+    SCENE_LOG_TRACE("Entity") << "Lendo cabeçalho da imagem:" << imagePath;
+
+    // Só o cabeçalho: os pixels são decodificados quando o pixmap for pedido
+    QSize imageSize;
+    if (QFileInfo::exists(imagePath)) {
+        imageSize = QImageReader(imagePath).size();
+        if (!imageSize.isValid()) {
+            // Formato sem leitura de tamanho pelo cabeçalho: decodificar uma vez para descobrir
+            imageSize = QImageReader(imagePath).read().size();
+        }
+    }
+
+    if (imageSize.isValid()) {
+        SCENE_LOG_TRACE("Entity") << "Imagem encontrada:" << imagePath;
+        definition.imageSize = imageSize;
+        definition.hasSprite = true;
+        definition.isInvisible = false;
+    } else {
+        SCENE_LOG_TRACE("Entity") << "Arquivo de imagem não encontrado ou falha ao carregar. Usando um pixmap padrão.";
+        // Usar o tamanho da colisão se disponível, caso contrário, usar um tamanho padrão
+        int width = definition.collisionSize.isValid() ? definition.collisionSize.width() : 64;
+        int height = definition.collisionSize.isValid() ? definition.collisionSize.height() : 64;
+        definition.imageSize = QSize(width, height);
+        definition.isInvisible = true;
+        definition.hasSprite = false;
+    }
+
+    SCENE_LOG_TRACE("Entity") << "Dimensões da imagem:" << definition.imageSize.width() << "x" << definition.imageSize.height();
+    SCENE_LOG_TRACE("Entity") << "Entidade é invisível:" << definition.isInvisible;
+    SCENE_LOG_TRACE("Entity") << "Entidade tem sprite:" << definition.hasSprite;
+    return true;
+}
+
+bool Entity::isInvisible() const
+{
+    // Uma entidade é considerada invisível se não tiver sprite
+    // ou se seu pixmap estiver vazio, mas tiver colisão.
+    // Sem <Sprite> no .ent não há imagem (nem pixmap padrão) para decodificar.
+    return m_imagePath.isEmpty() && !m_collisionSize.isEmpty();
+}
+
+void Entity::loadCustomSpriteDefinitions(EntityDefinition &definition, const QString &xmlPath) {
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Não foi possível abrir o arquivo XML:" << xmlPath;
+        return;
+    }
+
+    QXmlStreamReader xml(&file);
+    definition.spriteDefinitions.clear();
+
+    while (!xml.atEnd() && !xml.hasError()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+
+        if (token == QXmlStreamReader::StartElement) {
+            if (xml.name().compare(QLatin1String("sprite"), Qt::CaseInsensitive) == 0) {
+                int x = xml.attributes().value("x").toInt();
+                int y = xml.attributes().value("y").toInt();
+                int w = xml.attributes().value("w").toInt();
+                int h = xml.attributes().value("h").toInt();
+                definition.spriteDefinitions.append(QRectF(x, y, w, h));
+                SCENE_LOG_TRACE("Entity") << "Sprite definido:" << QRectF(x, y, w, h);
+            }
+        }
+    }
+
+    if (xml.hasError()) {
+        qWarning() << "Erro ao ler o arquivo XML:" << xml.errorString();
+    }
+
+    file.close();
+    SCENE_LOG_TRACE("Entity") << "Total de definições de sprite carregadas do XML:" << definition.spriteDefinitions.size();
+}
+
+void Entity::loadEntityDefinition(EntityDefinition &definition)
+{
+    const QString &filePath = definition.filePath;
+    SCENE_LOG_DEBUG("Entity") << "Iniciando carregamento da definição da entidade de:" << filePath;
+    if (!QFileInfo::exists(filePath)) {
+        qWarning() << "Arquivo de definição da entidade não encontrado:" << filePath;
+        return;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Falha ao abrir o arquivo de definição da entidade:" << filePath;
+        return;
+    }
+    QXmlStreamReader xml(&file);
+    QString spriteName;
+    int spriteCutX = 1, spriteCutY = 1;
+    while (!xml.atEnd() && !xml.hasError()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            if (xml.name().compare(QLatin1String("Entity"), Qt::CaseInsensitive) == 0) {
+                QString type = xml.attributes().value("type").toString().toLower();
+                if (type == "vertical") {
+                    definition.type = EntityType::Vertical;
+                } else if (type == "layerable") {
+                    definition.type = EntityType::Layerable;
+                } else if (type == "invisible") {
+                    definition.type = EntityType::Invisible;
+                    definition.isInvisible = true;
+                } else {
+                    definition.type = EntityType::Horizontal;
+                }
+            } else if (xml.name().compare(QLatin1String("Sprite"), Qt::CaseInsensitive) == 0) {
+                spriteName = xml.readElementText();
+                SCENE_LOG_TRACE("Entity") << "Nome do sprite encontrado:" << spriteName;
+                loadImage(definition, spriteName);
+            } else if (xml.name().compare(QLatin1String("SpriteCut"), Qt::CaseInsensitive) == 0) {
+                bool ok;
+                spriteCutX = xml.attributes().value("x").toInt(&ok);
+                if (!ok) {
+                    qWarning() << "Valor inválido para 'x' em SpriteCut";
+                    spriteCutX = 1;
+                }
+                spriteCutY = xml.attributes().value("y").toInt(&ok);
+                if (!ok) {
+                    qWarning() << "Valor inválido para 'y' em SpriteCut";
+                    spriteCutY = 1;
+                }
+                SCENE_LOG_TRACE("Entity") << "SpriteCut encontrado:" << spriteCutX << "x" << spriteCutY;
+            } else if (xml.name().compare(QLatin1String("Collision"), Qt::CaseInsensitive) == 0) {
+                loadCollisionInfo(definition, xml);
+            }
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "Erro ao analisar o arquivo XML:" << xml.errorString();
+    }
+    file.close();
+
+    QVector<QRectF> &spriteDefinitions = definition.spriteDefinitions;
+    const QSize &imageSize = definition.imageSize;
+    QSizeF &collisionSize = definition.collisionSize;
+
+    // Verificar se existe um arquivo XML personalizado para as definições de sprite
+    QString xmlPath = QFileInfo(filePath).absolutePath() + "/" + QFileInfo(spriteName).baseName() + ".xml";
+    definition.atlasPath = xmlPath;
+    SCENE_LOG_TRACE("Entity") << "Procurando arquivo XML personalizado:" << xmlPath;
+    if (QFile::exists(xmlPath)) {
+        SCENE_LOG_TRACE("Entity") << "Arquivo XML personalizado encontrado. Carregando definições...";
+        loadCustomSpriteDefinitions(definition, xmlPath);
+        SCENE_LOG_TRACE("Entity") << "Carregadas" << spriteDefinitions.size() << "definições de sprite personalizadas do XML";
+    }
+
+    // Se não há definições de sprite do XML e temos um SpriteCut válido, criar definições baseadas no SpriteCut
+    if (spriteDefinitions.isEmpty() && definition.hasSprite && spriteCutX > 0 && spriteCutY > 0) {
+        float spriteWidth = imageSize.width() / static_cast<float>(spriteCutX);
+        float spriteHeight = imageSize.height() / static_cast<float>(spriteCutY);
+        for (int y = 0; y < spriteCutY; ++y) {
+            for (int x = 0; x < spriteCutX; ++x) {
+                spriteDefinitions.append(QRectF(x * spriteWidth, y * spriteHeight, spriteWidth, spriteHeight));
+            }
+        }
+        SCENE_LOG_TRACE("Entity") << "Criadas" << spriteDefinitions.size() << "definições de sprite baseadas no SpriteCut";
+    }
+
+    // Se ainda não tem definições de sprite, mas tem pixmap, cria uma definição para o pixmap inteiro
+    if (spriteDefinitions.isEmpty() && !definition.imagePath.isEmpty()) {
+        spriteDefinitions.append(QRectF(0, 0, imageSize.width(), imageSize.height()));
+        SCENE_LOG_TRACE("Entity") << "Criada 1 definição de sprite para o pixmap inteiro";
+    }
+
+    // Se ainda não tem definições de sprite, mas tem tamanho de colisão, cria uma definição baseada no tamanho da colisão
+    if (spriteDefinitions.isEmpty() && !collisionSize.isNull()) {
+        spriteDefinitions.append(QRectF(0, 0, collisionSize.width(), collisionSize.height()));
+        definition.isInvisible = true;
+        SCENE_LOG_TRACE("Entity") << "Criada 1 definição de sprite para entidade invisível baseada no tamanho da colisão";
+    }
+
+    // Se o tamanho da colisão não foi definido, use o tamanho do primeiro sprite ou do pixmap
+    if (collisionSize.isNull()) {
+        if (!spriteDefinitions.isEmpty()) {
+            collisionSize = spriteDefinitions[0].size();
+        } else if (!definition.imagePath.isEmpty()) {
+            collisionSize = imageSize;
+        }
+        SCENE_LOG_TRACE("Entity") << "Tamanho da colisão definido automaticamente:" << collisionSize;
+    }
+
+    if (spriteDefinitions.isEmpty()) {
+        qWarning() << "Nenhuma definição de sprite criada para a entidade:" << definition.name;
+    }
+
+    // Um retângulo por sprite: só no nível Trace, o catálogo inteiro passa por aqui
+    if (AsyncLogger::shouldLog(AsyncLogger::Trace)) {
+        SCENE_LOG_TRACE("Entity") << "Definições de sprite finais:";
+        for (int i = 0; i < spriteDefinitions.size(); ++i) {
+            SCENE_LOG_TRACE("Entity") << i << ":" << spriteDefinitions[i];
+        }
+    }
+}
+
+bool Entity::hasOnlyCollision() const {
+    return !hasSprite() && !isInvisible();
+}
+
+void Entity::loadCollisionInfo(EntityDefinition &definition, QXmlStreamReader &xml)
+{
+    while (!(xml.tokenType() == QXmlStreamReader::EndElement && xml.name().compare(QLatin1String("Collision"), Qt::CaseInsensitive) == 0)) {
+        if (xml.tokenType() == QXmlStreamReader::StartElement) {
+            if (xml.name().compare(QLatin1String("Size"), Qt::CaseInsensitive) == 0) {
+                bool ok;
+                float width = xml.attributes().value("x").toFloat(&ok);
+                float height = xml.attributes().value("y").toFloat(&ok);
+                if (ok) {
+                    definition.collisionSize = QSizeF(width, height);
+                    SCENE_LOG_TRACE("Entity") << "Tamanho da colisão definido:" << definition.collisionSize;
+                } else {
+                    qWarning() << "Valores inválidos para o tamanho da colisão";
+                }
+            }
+        }
+        xml.readNext();
+    }
+}
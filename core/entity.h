@@ -0,0 +1,111 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include <QString>
+#include <QPixmap>
+#include <QImage>
+#include <QVector>
+#include <QRectF>
+#include <QSizeF>
+#include <QXmlStreamReader>
+
+// Adicione este enum no início do arquivo, fora da classe
+enum class EntityType {
+    Horizontal,
+    Vertical,
+    Layerable,
+    Invisible
+};
+
+class SpritesheetCache;
+
+// Metadados de uma entidade lidos do disco (.ent, atlas .xml e cabeçalho da imagem).
+// Não contém objetos de GUI nem pixels, então pode ser montado em threads de trabalho;
+// a imagem só é decodificada quando Entity::getPixmap() é chamado na thread da GUI.
+struct EntityDefinition
+{
+    QString name;
+    QString filePath;
+    QString imagePath;  // Vazio se o .ent não tiver <Sprite>
+    QString atlasPath;  // Caminho do atlas .xml procurado (pode não existir)
+    EntityType type = EntityType::Horizontal;
+    QSize imageSize = QSize(0, 0);  // Tamanho da imagem (ou do pixmap padrão, se ela faltar)
+    QVector<QRectF> spriteDefinitions;
+    QSizeF collisionSize;
+    bool isInvisible = false;
+    bool hasSprite = true;
+};
+
+class Entity
+{
+public:
+    Entity(const QString &name, const QString &filePath);
+    explicit Entity(const EntityDefinition &definition, SpritesheetCache *cache = nullptr);
+    ~Entity();
+
+    // Lê e interpreta a definição da entidade sem tocar em QPixmap (seguro fora da thread da GUI)
+    static EntityDefinition loadDefinition(const QString &name, const QString &filePath);
+
+    QString getName() const { return m_name; }
+    // Decodifica o spritesheet na primeira chamada (apenas na thread da GUI)
+    QPixmap getPixmap() const;
+    QSize getImageSize() const { return m_imageSize; }
+    bool isImageDecoded() const { return !m_pixmap.isNull(); }
+    qint64 decodedBytes() const;
+    // Chamado pelo SpritesheetCache ao despejar a entrada
+    void releaseDecodedImage() const;
+
+    // Colocações vivas na cena que usam esta entidade; impedem o despejo do spritesheet
+    void addPlacementRef() { ++m_placementRefs; }
+    void releasePlacementRef() { --m_placementRefs; }
+    int placementRefCount() const { return m_placementRefs; }
+
+    QVector<QRectF> getSpriteDefinitions() const { return m_spriteDefinitions; }
+    int getSelectedTileIndex() const { return m_selectedTileIndex; }
+    void setSelectedTileIndex(int index) { m_selectedTileIndex = index; }
+    bool hasSprite() const { return m_hasSprite; }
+    QSizeF getCollisionSize() const { return m_collisionSize; }
+    bool hasOnlyCollision() const;
+    bool isInvisible() const;
+
+    // Adicione estes novos métodos
+    EntityType getType() const { return m_type; }
+    QSizeF getCurrentSize() const {
+        if (m_isInvisible) {
+            return m_collisionSize;
+        }
+        if (m_spriteDefinitions.isEmpty()) {
+            return m_imageSize;
+        }
+        QSizeF tileSize = m_spriteDefinitions[m_selectedTileIndex].size();
+        if (m_type == EntityType::Vertical) {
+            return QSizeF(tileSize.width(), tileSize.width());
+        }
+        return tileSize;
+    }
+
+private:
+    // Adicione este novo membro
+    EntityType m_type;
+
+    QString m_name;
+    QString m_imagePath;
+    QSize m_imageSize;
+    mutable QPixmap m_pixmap;
+    SpritesheetCache *m_cache;
+    int m_placementRefs;
+    QVector<QRectF> m_spriteDefinitions;
+    int m_selectedTileIndex;
+    bool m_isInvisible;
+    bool m_hasSprite;
+    QSizeF m_collisionSize;
+
+    static void loadEntityDefinition(EntityDefinition &definition);
+    static bool loadImage(EntityDefinition &definition, const QString &imageName);
+    static bool loadImageInfo(EntityDefinition &definition);
+    static QImage renderPlaceholderImage(const QString &name, const QSize &size);
+    static void loadCollisionInfo(EntityDefinition &definition, QXmlStreamReader &xml);
+    static void loadCustomSpriteDefinitions(EntityDefinition &definition, const QString &xmlPath);
+};
+
+#endif // ENTITY_H
@@ -0,0 +1,460 @@
+#include "entitycatalogcache.h"
+#include <QDir>
+#include <QDebug>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char kCatalogMagic[8] = { 'E', 'D', 'C', 'A', 'T', 'L', 'G', '1' };
+const quint32 kCatalogVersion = 1;
+
+enum CatalogFlags : quint8 {
+    FlagInvisible = 0x01,
+    FlagHasSprite = 0x02
+};
+
+enum CatalogStampIndex {
+    StampEntity = 0,
+    StampAtlas = 1,
+    StampImage = 2,
+    StampCount = 3
+};
+
+}
+
+struct EntityCatalogCache::CatalogHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 entryCount;
+    quint32 rectCount;
+    quint32 stringBytes;
+    quint64 reserved;
+};
+
+struct EntityCatalogCache::CatalogStamp
+{
+    quint32 pathOffset;
+    quint32 pathLength;  // 0 = sem arquivo associado
+    qint64 modified;     // ms desde a época
+    qint64 size;         // -1 = arquivo não existia
+    quint64 hash;        // FNV-1a 64 do conteúdo
+};
+
+struct EntityCatalogCache::CatalogEntry
+{
+    quint32 nameOffset;
+    quint32 nameLength;
+    CatalogStamp stamps[StampCount];
+    quint32 firstRect;
+    quint32 rectCount;
+    float collisionWidth;
+    float collisionHeight;
+    qint32 imageWidth;
+    qint32 imageHeight;
+    quint8 type;
+    quint8 flags;
+    quint8 padding[6];
+};
+
+struct EntityCatalogCache::CatalogRect
+{
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+EntityCatalogCache::EntityCatalogCache()
+    : m_data(nullptr),
+      m_size(0)
+{
+    // O arquivo é lido direto do mapeamento, então o layout não pode mudar sem trocar a versão
+    static_assert(sizeof(CatalogHeader) == 32, "layout do cabeçalho mudou");
+    static_assert(sizeof(CatalogStamp) == 32, "layout do carimbo mudou");
+    static_assert(sizeof(CatalogEntry) == 136, "layout da entrada mudou");
+    static_assert(sizeof(CatalogRect) == 16, "layout do retângulo mudou");
+}
+
+EntityCatalogCache::~EntityCatalogCache()
+{
+    close();
+}
+
+QString EntityCatalogCache::cachePathForEntitiesDirectory(const QString &entitiesPath)
+{
+    return QDir::cleanPath(QDir(entitiesPath).absoluteFilePath("../.editorcache/catalog.bin"));
+}
+
+bool EntityCatalogCache::open(const QString &cachePath)
+{
+    close();
+
+    m_file.setFileName(cachePath);
+    if (!m_file.exists()) {
+        qDebug() << "Cache de catálogo inexistente:" << cachePath;
+        return false;
+    }
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Não foi possível abrir o cache de catálogo:" << cachePath;
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(CatalogHeader))) {
+        qWarning() << "Cache de catálogo truncado:" << cachePath;
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        qWarning() << "Falha ao mapear o cache de catálogo:" << cachePath;
+        close();
+        return false;
+    }
+
+    const CatalogHeader *h = header();
+    if (std::memcmp(h->magic, kCatalogMagic, sizeof(kCatalogMagic)) != 0 || h->version != kCatalogVersion) {
+        qDebug() << "Cache de catálogo com formato antigo ou desconhecido, será recriado";
+        close();
+        return false;
+    }
+
+    qint64 expectedSize = static_cast<qint64>(sizeof(CatalogHeader))
+                          + static_cast<qint64>(h->entryCount) * sizeof(CatalogEntry)
+                          + static_cast<qint64>(h->rectCount) * sizeof(CatalogRect)
+                          + h->stringBytes;
+    if (expectedSize != m_size) {
+        qWarning() << "Cache de catálogo inconsistente:" << m_size << "bytes, esperado" << expectedSize;
+        close();
+        return false;
+    }
+
+    // Uma vez aqui, para lookup() poder ler nomes, caminhos e retângulos sem conferir nada
+    if (!rangesAreValid()) {
+        qWarning() << "Cache de catálogo com faixas fora do arquivo, será recriado:" << cachePath;
+        close();
+        return false;
+    }
+
+    qDebug() << "Cache de catálogo mapeado:" << cachePath << "-" << h->entryCount << "entradas";
+    return true;
+}
+
+void EntityCatalogCache::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+}
+
+int EntityCatalogCache::entryCount() const
+{
+    return m_data ? static_cast<int>(header()->entryCount) : 0;
+}
+
+const EntityCatalogCache::CatalogHeader *EntityCatalogCache::header() const
+{
+    return reinterpret_cast<const CatalogHeader*>(m_data);
+}
+
+const EntityCatalogCache::CatalogEntry *EntityCatalogCache::entries() const
+{
+    return reinterpret_cast<const CatalogEntry*>(m_data + sizeof(CatalogHeader));
+}
+
+const EntityCatalogCache::CatalogRect *EntityCatalogCache::rects() const
+{
+    return reinterpret_cast<const CatalogRect*>(entries() + header()->entryCount);
+}
+
+const char *EntityCatalogCache::strings() const
+{
+    return reinterpret_cast<const char*>(rects() + header()->rectCount);
+}
+
+bool EntityCatalogCache::rangesAreValid() const
+{
+    const quint64 stringBytes = header()->stringBytes;
+    const quint64 rectCount = header()->rectCount;
+    const CatalogEntry *entry = entries();
+    for (quint32 i = 0; i < header()->entryCount; ++i, ++entry) {
+        if (static_cast<quint64>(entry->nameOffset) + entry->nameLength > stringBytes
+            || static_cast<quint64>(entry->firstRect) + entry->rectCount > rectCount) {
+            return false;
+        }
+        for (const CatalogStamp &stamp : entry->stamps) {
+            if (static_cast<quint64>(stamp.pathOffset) + stamp.pathLength > stringBytes) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QString EntityCatalogCache::stringAt(quint32 offset, quint32 length) const
+{
+    if (static_cast<quint64>(offset) + length > header()->stringBytes) {
+        return QString();
+    }
+    return QString::fromUtf8(strings() + offset, static_cast<int>(length));
+}
+
+bool EntityCatalogCache::isStampValid(const CatalogStamp &stamp) const
+{
+    if (stamp.pathLength == 0) {
+        return true;
+    }
+
+    QString path = stringAt(stamp.pathOffset, stamp.pathLength);
+    QFileInfo info(path);
+    if (!info.exists()) {
+        return stamp.size < 0;
+    }
+    if (stamp.size < 0 || info.size() != stamp.size) {
+        return false;
+    }
+    if (info.lastModified().toMSecsSinceEpoch() == stamp.modified) {
+        return true;
+    }
+
+    // mtime mudou mas o tamanho é o mesmo (checkout, cópia, touch): decidir pelo conteúdo
+    return hashFile(path) == stamp.hash;
+}
+
+bool EntityCatalogCache::lookup(const QString &name, const QString &filePath, EntityDefinition &definition) const
+{
+    if (!m_data) {
+        return false;
+    }
+
+    const QByteArray key = name.toUtf8();
+    const CatalogEntry *begin = entries();
+    const CatalogEntry *end = begin + header()->entryCount;
+    const char *pool = strings();
+
+    // As entradas são gravadas ordenadas pelos bytes UTF-8 do nome
+    auto compareName = [&](const CatalogEntry &entry, const QByteArray &value) {
+        int common = static_cast<int>(qMin<quint32>(entry.nameLength, static_cast<quint32>(value.size())));
+        int result = std::memcmp(pool + entry.nameOffset, value.constData(), common);
+        return result != 0 ? result < 0 : static_cast<int>(entry.nameLength) < value.size();
+    };
+    const CatalogEntry *entry = std::lower_bound(begin, end, key, compareName);
+    if (entry == end || entry->nameLength != static_cast<quint32>(key.size())
+        || std::memcmp(pool + entry->nameOffset, key.constData(), key.size()) != 0) {
+        return false;
+    }
+
+    const CatalogStamp &entityStamp = entry->stamps[StampEntity];
+    if (stringAt(entityStamp.pathOffset, entityStamp.pathLength) != QFileInfo(filePath).absoluteFilePath()) {
+        return false;
+    }
+    for (const CatalogStamp &stamp : entry->stamps) {
+        if (!isStampValid(stamp)) {
+            return false;
+        }
+    }
+    if (static_cast<quint64>(entry->firstRect) + entry->rectCount > header()->rectCount) {
+        return false;
+    }
+
+    definition.name = name;
+    definition.filePath = filePath;
+    definition.atlasPath = stringAt(entry->stamps[StampAtlas].pathOffset, entry->stamps[StampAtlas].pathLength);
+    definition.imagePath = stringAt(entry->stamps[StampImage].pathOffset, entry->stamps[StampImage].pathLength);
+    definition.type = static_cast<EntityType>(entry->type);
+    definition.isInvisible = entry->flags & FlagInvisible;
+    definition.hasSprite = entry->flags & FlagHasSprite;
+    definition.collisionSize = QSizeF(entry->collisionWidth, entry->collisionHeight);
+    definition.imageSize = QSize(entry->imageWidth, entry->imageHeight);
+
+    definition.spriteDefinitions.clear();
+    definition.spriteDefinitions.reserve(static_cast<int>(entry->rectCount));
+    const CatalogRect *rect = rects() + entry->firstRect;
+    for (quint32 i = 0; i < entry->rectCount; ++i, ++rect) {
+        definition.spriteDefinitions.append(QRectF(rect->x, rect->y, rect->width, rect->height));
+    }
+    return true;
+}
+
+bool EntityCatalogCache::write(const QString &cachePath, const QVector<EntityDefinition> &definitions)
+{
+    return write(cachePath, definitions, QHash<QString, CatalogStamp>());
+}
+
+bool EntityCatalogCache::rewrite(const QString &cachePath, const QVector<EntityDefinition> &definitions)
+{
+    // Carimbos do cache atual por caminho, copiados antes de fechar o mapeamento
+    QHash<QString, CatalogStamp> previousStamps;
+    if (m_data) {
+        const CatalogEntry *entry = entries();
+        for (quint32 i = 0; i < header()->entryCount; ++i, ++entry) {
+            for (const CatalogStamp &stamp : entry->stamps) {
+                if (stamp.pathLength > 0) {
+                    previousStamps.insert(stringAt(stamp.pathOffset, stamp.pathLength), stamp);
+                }
+            }
+        }
+    }
+    close();
+    return write(cachePath, definitions, previousStamps);
+}
+
+bool EntityCatalogCache::write(const QString &cachePath, const QVector<EntityDefinition> &definitions,
+                               const QHash<QString, CatalogStamp> &previousStamps)
+{
+    QFileInfo cacheInfo(cachePath);
+    if (!QDir().mkpath(cacheInfo.absolutePath())) {
+        qWarning() << "Não foi possível criar o diretório do cache de catálogo:" << cacheInfo.absolutePath();
+        return false;
+    }
+
+    // Ordenar pelos bytes UTF-8 do nome para permitir busca binária direto no mapeamento
+    QVector<QPair<QByteArray, const EntityDefinition*>> sorted;
+    sorted.reserve(definitions.size());
+    for (const EntityDefinition &definition : definitions) {
+        sorted.append(qMakePair(definition.name.toUtf8(), &definition));
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const QPair<QByteArray, const EntityDefinition*> &a,
+                                               const QPair<QByteArray, const EntityDefinition*> &b) {
+        return a.first < b.first;
+    });
+
+    QByteArray stringPool;
+    QVector<CatalogEntry> entryTable;
+    QVector<CatalogRect> rectTable;
+    entryTable.reserve(sorted.size());
+
+    auto appendString = [&stringPool](const QByteArray &value, quint32 &offset, quint32 &length) {
+        offset = static_cast<quint32>(stringPool.size());
+        length = static_cast<quint32>(value.size());
+        stringPool.append(value);
+    };
+
+    // Um carimbo por arquivo: um spritesheet usado por muitas entidades é lido uma vez só,
+    // e o hash de um arquivo sem mudança de mtime e tamanho vem do cache anterior
+    QHash<QString, CatalogStamp> stamps;
+    int hashedFiles = 0;
+    auto makeStamp = [&](const QString &path, CatalogStamp &stamp) {
+        std::memset(&stamp, 0, sizeof(stamp));
+        if (path.isEmpty()) {
+            return;
+        }
+        QFileInfo info(path);
+        const QString absolutePath = info.absoluteFilePath();
+        auto known = stamps.constFind(absolutePath);
+        if (known != stamps.constEnd()) {
+            stamp = known.value();
+            return;
+        }
+
+        appendString(absolutePath.toUtf8(), stamp.pathOffset, stamp.pathLength);
+        if (info.exists()) {
+            stamp.modified = info.lastModified().toMSecsSinceEpoch();
+            stamp.size = info.size();
+            auto previous = previousStamps.constFind(absolutePath);
+            if (previous != previousStamps.constEnd() && previous->modified == stamp.modified
+                && previous->size == stamp.size) {
+                stamp.hash = previous->hash;
+            } else {
+                stamp.hash = hashFile(path);
+                ++hashedFiles;
+            }
+        } else {
+            stamp.size = -1;
+        }
+        stamps.insert(absolutePath, stamp);
+    };
+
+    for (const auto &pair : sorted) {
+        const EntityDefinition &definition = *pair.second;
+
+        CatalogEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        appendString(pair.first, entry.nameOffset, entry.nameLength);
+        makeStamp(definition.filePath, entry.stamps[StampEntity]);
+        makeStamp(definition.atlasPath, entry.stamps[StampAtlas]);
+        makeStamp(definition.imagePath, entry.stamps[StampImage]);
+
+        entry.firstRect = static_cast<quint32>(rectTable.size());
+        entry.rectCount = static_cast<quint32>(definition.spriteDefinitions.size());
+        for (const QRectF &rect : definition.spriteDefinitions) {
+            rectTable.append({ static_cast<float>(rect.x()), static_cast<float>(rect.y()),
+                               static_cast<float>(rect.width()), static_cast<float>(rect.height()) });
+        }
+
+        entry.collisionWidth = static_cast<float>(definition.collisionSize.width());
+        entry.collisionHeight = static_cast<float>(definition.collisionSize.height());
+        entry.imageWidth = definition.imageSize.width();
+        entry.imageHeight = definition.imageSize.height();
+        entry.type = static_cast<quint8>(definition.type);
+        entry.flags = (definition.isInvisible ? FlagInvisible : 0) | (definition.hasSprite ? FlagHasSprite : 0);
+        entryTable.append(entry);
+    }
+
+    CatalogHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kCatalogMagic, sizeof(kCatalogMagic));
+    h.version = kCatalogVersion;
+    h.entryCount = static_cast<quint32>(entryTable.size());
+    h.rectCount = static_cast<quint32>(rectTable.size());
+    h.stringBytes = static_cast<quint32>(stringPool.size());
+
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar o cache de catálogo:" << cachePath;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    file.write(reinterpret_cast<const char*>(entryTable.constData()), entryTable.size() * sizeof(CatalogEntry));
+    file.write(reinterpret_cast<const char*>(rectTable.constData()), rectTable.size() * sizeof(CatalogRect));
+    file.write(stringPool);
+    if (!file.commit()) {
+        qWarning() << "Falha ao gravar o cache de catálogo:" << cachePath << "-" << file.errorString();
+        return false;
+    }
+
+    qDebug() << "Cache de catálogo gravado:" << cachePath << "-" << entryTable.size() << "entradas,"
+             << hashedFiles << "arquivos lidos para o hash";
+    return true;
+}
+
+quint64 EntityCatalogCache::hashFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    // FNV-1a 64 bits: estável entre execuções (qHash usa semente aleatória por processo)
+    quint64 hash = 14695981039346656037ULL;
+    auto feed = [&hash](const uchar *data, qint64 size) {
+        for (qint64 i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    qint64 size = file.size();
+    if (size == 0) {
+        return hash;
+    }
+    if (uchar *data = file.map(0, size)) {
+        feed(data, size);
+        file.unmap(data);
+    } else {
+        QByteArray content = file.readAll();
+        feed(reinterpret_cast<const uchar*>(content.constData()), content.size());
+    }
+    return hash;
+}
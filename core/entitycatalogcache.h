@@ -0,0 +1,66 @@
+#ifndef ENTITYCATALOGCACHE_H
+#define ENTITYCATALOGCACHE_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "entity.h"
+
+// Cache binário do catálogo de entidades (.editorcache/catalog.bin).
+//
+// Guarda os metadados já interpretados de cada entidade (tipo, definições de sprite,
+// tamanho da colisão, dimensões da imagem) junto com os carimbos (mtime, tamanho e hash)
+// do .ent, do atlas .xml e da imagem. O arquivo tem layout fixo e é lido via mmap:
+//
+//   CatalogHeader | CatalogEntry[entryCount] (ordenadas por nome) | CatalogRect[rectCount] | strings UTF-8
+//
+// Um projeto sem mudanças abre validando os carimbos, sem nenhuma leitura de XML.
+class EntityCatalogCache
+{
+public:
+    EntityCatalogCache();
+    ~EntityCatalogCache();
+
+    // Caminho padrão do cache para um diretório "entities" de projeto
+    static QString cachePathForEntitiesDirectory(const QString &entitiesPath);
+
+    bool open(const QString &cachePath);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    int entryCount() const;
+
+    // Preenche a definição a partir do cache se a entrada existir e todos os carimbos
+    // ainda baterem com o disco. Só lê o mapeamento, então pode ser chamado de várias threads.
+    bool lookup(const QString &name, const QString &filePath, EntityDefinition &definition) const;
+
+    static bool write(const QString &cachePath, const QVector<EntityDefinition> &definitions);
+    // Igual ao write(), mas reaproveita o hash dos arquivos que não mudaram (mesmo mtime e
+    // tamanho) desde este cache; fecha o mapeamento antes de substituir o arquivo
+    bool rewrite(const QString &cachePath, const QVector<EntityDefinition> &definitions);
+
+private:
+    struct CatalogHeader;
+    struct CatalogStamp;
+    struct CatalogEntry;
+    struct CatalogRect;
+
+    const CatalogHeader *header() const;
+    const CatalogEntry *entries() const;
+    const CatalogRect *rects() const;
+    const char *strings() const;
+    // Nomes, caminhos e retângulos de todas as entradas dentro do arquivo
+    bool rangesAreValid() const;
+    QString stringAt(quint32 offset, quint32 length) const;
+    bool isStampValid(const CatalogStamp &stamp) const;
+
+    static bool write(const QString &cachePath, const QVector<EntityDefinition> &definitions,
+                      const QHash<QString, CatalogStamp> &previousStamps);
+    static quint64 hashFile(const QString &path);
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+};
+
+#endif // ENTITYCATALOGCACHE_H
@@ -0,0 +1,203 @@
+#include "entitymanager.h"
+#include "entity.h"
+#include "entitycatalogcache.h"
+#include "asynclogger.h"
+#include "tracerecorder.h"
+#include <QDir>
+#include <QDebug>
+#include <QFileInfo>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QtConcurrent>
+
+namespace {
+
+// Functor usado pelo QtConcurrent: tenta o cache de catálogo e só interpreta
+// o .ent/atlas quando a entrada está ausente ou desatualizada.
+struct DefinitionLoader
+{
+    typedef EntityDefinition result_type;
+
+    const EntityCatalogCache *cache;
+    QAtomicInt *cacheHits;
+
+    EntityDefinition operator()(const QFileInfo &fileInfo) const
+    {
+        TraceSpan span("Entity::load", "load");
+        span.addArg("entity", fileInfo.baseName());
+        EntityDefinition definition;
+        if (cache && cache->lookup(fileInfo.baseName(), fileInfo.filePath(), definition)) {
+            cacheHits->fetchAndAddRelaxed(1);
+            span.addArg("cached", 1);
+            return definition;
+        }
+        span.addArg("cached", 0);
+        return Entity::loadDefinition(fileInfo.baseName(), fileInfo.filePath());
+    }
+};
+
+}
+
+EntityManager::EntityManager()
+    : m_catalogCacheEnabled(true)
+{
+}
+
+EntityManager::~EntityManager()
+{
+    qDeleteAll(m_entities);
+    m_entities.clear();
+}
+
+void EntityManager::loadEntitiesFromDirectory(const QString &path, LoadMode mode)
+{
+    TraceSpan span("EntityManager::loadEntitiesFromDirectory", "load");
+    span.addArg("path", path);
+    QElapsedTimer timer;
+    timer.start();
+
+    SCENE_LOG_DEBUG("EntityManager") << "Iniciando carregamento de entidades do diretório:" << path;
+    SCENE_LOG_DEBUG("EntityManager") << "Caminho absoluto:" << QDir(path).absolutePath();
+
+    if (path.isEmpty()) {
+        qWarning() << "Caminho do diretório vazio";
+        return;
+    }
+
+    QDir dir(path);
+    if (!dir.exists()) {
+        qWarning() << "Diretório não encontrado:" << path;
+        return;
+    }
+
+    // Limpar entidades existentes antes de carregar novas
+    SCENE_LOG_DEBUG("EntityManager") << "Limpando entidades existentes...";
+    qDeleteAll(m_entities);
+    m_entities.clear();
+
+    QStringList filters;
+    filters << "*.ent";
+    QFileInfoList fileList = dir.entryInfoList(filters, QDir::Files);
+
+    if (fileList.isEmpty()) {
+        qWarning() << "Nenhum arquivo .ent encontrado no diretório:" << path;
+        return;
+    }
+
+    SCENE_LOG_DEBUG("EntityManager") << "Encontrados" << fileList.size() << "arquivos .ent no diretório";
+
+    // Filtrar nomes inválidos e duplicados antes de distribuir o trabalho entre as threads
+    QVector<QFileInfo> filesToLoad;
+    filesToLoad.reserve(fileList.size());
+    QSet<QString> seenNames;
+    for (const QFileInfo &fileInfo : fileList)
+    {
+        QString name = fileInfo.baseName();
+        QString filePath = fileInfo.filePath();
+
+        SCENE_LOG_TRACE("EntityManager") << "Processando arquivo:" << filePath;
+
+        if (name.isEmpty()) {
+            qWarning() << "Nome de arquivo inválido:" << filePath;
+            continue;
+        }
+
+        if (seenNames.contains(name)) {
+            qWarning() << "Entidade duplicada encontrada:" << name;
+            continue;
+        }
+        seenNames.insert(name);
+        filesToLoad.append(fileInfo);
+    }
+
+    EntityCatalogCache catalogCache;
+    const QString cachePath = EntityCatalogCache::cachePathForEntitiesDirectory(path);
+    if (m_catalogCacheEnabled) {
+        catalogCache.open(cachePath);
+    }
+    QAtomicInt cacheHits(0);
+    DefinitionLoader loader = { catalogCache.isOpen() ? &catalogCache : nullptr, &cacheHits };
+
+    QVector<EntityDefinition> definitions;
+    int threadCount = 1;
+    if (mode == LoadMode::Parallel) {
+        threadCount = QThreadPool::globalInstance()->maxThreadCount();
+        SCENE_LOG_DEBUG("EntityManager") << "Carregando definições em paralelo com" << threadCount << "threads";
+        definitions = QtConcurrent::blockingMapped<QVector<EntityDefinition>>(filesToLoad, loader);
+    } else {
+        definitions.reserve(filesToLoad.size());
+        for (const QFileInfo &fileInfo : filesToLoad) {
+            definitions.append(loader(fileInfo));
+        }
+    }
+
+    // Regravar o cache só quando algo mudou (entradas novas, alteradas ou removidas)
+    const int hits = cacheHits.loadRelaxed();
+    SCENE_LOG_DEBUG("EntityManager") << "Cache de catálogo:" << hits << "de" << definitions.size() << "entidades reaproveitadas";
+    if (m_catalogCacheEnabled && (hits != definitions.size() || catalogCache.entryCount() != definitions.size())) {
+        catalogCache.rewrite(cachePath, definitions);
+    }
+
+    // A inserção no mapa acontece na thread da GUI; as imagens só são decodificadas sob demanda
+    int successfullyLoaded = 0;
+    for (const EntityDefinition &definition : definitions)
+    {
+        try {
+            SCENE_LOG_TRACE("EntityManager") << "Criando nova entidade:" << definition.name;
+            Entity *entity = new Entity(definition, &m_spritesheetCache);
+            // Removemos a verificação de pixmap nulo
+            m_entities[definition.name] = entity;
+            successfullyLoaded++;
+            SCENE_LOG_TRACE("EntityManager") << "Entidade carregada com sucesso:" << definition.name
+                                             << "- Tamanho da imagem:" << entity->getImageSize()
+                                             << "- Número de definições de sprite:" << entity->getSpriteDefinitions().size()
+                                             << "- É invisível:" << entity->isInvisible();
+        } catch (const std::exception& e) {
+            qWarning() << "Erro ao criar entidade:" << definition.name << "-" << e.what();
+        }
+    }
+
+    SCENE_LOG_DEBUG("EntityManager") << "Total de entidades carregadas com sucesso:" << successfullyLoaded << "de" << fileList.size() << "arquivos";
+    span.addArg("entities", successfullyLoaded);
+    span.addArg("cacheHits", hits);
+
+    if (m_entities.isEmpty()) {
+        qWarning() << "Nenhuma entidade foi carregada com sucesso. Verifique o conteúdo dos arquivos .ent e os logs acima para mais detalhes.";
+    } else if (AsyncLogger::shouldLog(AsyncLogger::Trace)) {
+        SCENE_LOG_TRACE("EntityManager") << "Entidades carregadas:";
+        for (const QString &name : m_entities.keys()) {
+            SCENE_LOG_TRACE("EntityManager") << "  -" << name;
+        }
+    }
+
+    SCENE_LOG_DEBUG("EntityManager") << "Tempo total de carregamento:" << timer.elapsed() << "ms -"
+                                     << (mode == LoadMode::Parallel ? "paralelo" : "sequencial") << "com" << threadCount << "threads";
+}
+
+Entity* EntityManager::getEntityByName(const QString &name) const
+{
+    if (name.isEmpty()) {
+        qWarning() << "Nome de entidade vazio";
+        return nullptr;
+    }
+
+    auto it = m_entities.find(name);
+    if (it != m_entities.end()) {
+        return it.value();
+    } else {
+        qWarning() << "Entidade não encontrada:" << name;
+        return nullptr;
+    }
+}
+
+void EntityManager::setCatalogCacheEnabled(bool enabled)
+{
+    m_catalogCacheEnabled = enabled;
+}
+
+QVector<Entity*> EntityManager::getAllEntities() const
+{
+    return m_entities.values().toVector();
+}
@@ -0,0 +1,43 @@
+#ifndef ENTITYMANAGER_H
+#define ENTITYMANAGER_H
+
+#include <QVector>
+#include <QString>
+#include <QMap>
+#include "spritesheetcache.h"
+
+class Entity;
+
+class EntityManager
+{
+public:
+    // Sequential: tudo na thread chamadora (comportamento antigo).
+    // Parallel: .ent, atlas e cabeçalhos das imagens são lidos no pool global de threads;
+    // só a inserção em m_entities fica na thread da GUI.
+    enum class LoadMode {
+        Sequential,
+        Parallel
+    };
+
+    EntityManager();
+    ~EntityManager();
+
+    void loadEntitiesFromDirectory(const QString &path, LoadMode mode = LoadMode::Parallel);
+    Entity* getEntityByName(const QString &name) const;
+    QVector<Entity*> getAllEntities() const;
+
+    // Usa/atualiza .editorcache/catalog.bin ao lado do diretório de entidades
+    void setCatalogCacheEnabled(bool enabled);
+    bool isCatalogCacheEnabled() const { return m_catalogCacheEnabled; }
+
+    // Orçamento e total de bytes dos spritesheets decodificados sob demanda
+    SpritesheetCache &spritesheetCache() { return m_spritesheetCache; }
+    const SpritesheetCache &spritesheetCache() const { return m_spritesheetCache; }
+
+private:
+    SpritesheetCache m_spritesheetCache;
+    QMap<QString, Entity*> m_entities;
+    bool m_catalogCacheEnabled;
+};
+
+#endif // ENTITYMANAGER_H
@@ -0,0 +1,150 @@
+#include "incrementalscenesaver.h"
+#include "sceneserializer.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace {
+
+// Functor usado pelo QtConcurrent: formata uma seção suja
+struct SectionFormatter
+{
+    typedef QByteArray result_type;
+
+    const SceneSerializer *serializer;
+
+    QByteArray operator()(const SceneSerializer::Section &section) const
+    {
+        return serializer->formatRange(section.firstRecord, section.recordCount);
+    }
+};
+
+}
+
+IncrementalSceneSaver::IncrementalSceneSaver()
+    : m_fileSize(-1)
+{
+    m_stats = Stats{0, 0, 0, 0};
+}
+
+bool IncrementalSceneSaver::canReuse(const QString &path) const
+{
+    if (m_path.isEmpty() || path != m_path) {
+        return false;
+    }
+    const QFileInfo info(path);
+    return info.exists() && info.size() == m_fileSize && info.lastModified() == m_modified;
+}
+
+void IncrementalSceneSaver::invalidate()
+{
+    m_path.clear();
+    m_fileSize = -1;
+    m_modified = QDateTime();
+    m_sections.clear();
+}
+
+bool IncrementalSceneSaver::save(const QString &path, const SceneSerializer &scene)
+{
+    const QVector<SceneSerializer::Section> &sections = scene.sections();
+    const bool reuse = canReuse(path);
+
+    QVector<SceneSerializer::Section> dirtySections;
+    bool hasEntities = false;
+    for (const SceneSerializer::Section &section : sections) {
+        if (section.dirty) {
+            dirtySections.append(section);
+            hasEntities = hasEntities || section.recordCount > 0;
+        } else if (!reuse || !m_sections.contains(section.key)) {
+            qWarning() << "Seção limpa sem bytes no arquivo anterior, save incremental abortado:" << path;
+            invalidate();
+            return false;
+        } else {
+            hasEntities = true;
+        }
+    }
+
+    // As seções sujas são formatadas em paralelo, antes de abrir qualquer arquivo
+    const QVector<QByteArray> formatted = scene.isParallel() && dirtySections.size() > 1
+            ? QtConcurrent::blockingMapped(dirtySections, SectionFormatter{&scene})
+            : QVector<QByteArray>();
+
+    // O arquivo anterior fica mapeado até o commit; o novo vai para um temporário
+    QFile previous(path);
+    const uchar *previousData = nullptr;
+    if (reuse && sections.size() > dirtySections.size()) {
+        if (!previous.open(QIODevice::ReadOnly) || !(previousData = previous.map(0, m_fileSize))) {
+            qWarning() << "Não foi possível mapear a cena anterior:" << path;
+            invalidate();
+            return false;
+        }
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar a cena:" << path;
+        return false;
+    }
+
+    Stats stats = Stats{sections.size(), 0, 0, 0};
+    QHash<quint64, ByteRange> ranges;
+    ranges.reserve(sections.size());
+
+    qint64 offset = 0;
+    auto writeBytes = [&](const char *data, qint64 length) {
+        offset += length;
+        return file.write(data, length) == length;
+    };
+
+    const QByteArray header = SceneSerializer::escHeader(hasEntities);
+    bool ok = writeBytes(header.constData(), header.size());
+
+    int dirtyIndex = 0;
+    for (const SceneSerializer::Section &section : sections) {
+        if (!ok) {
+            break;
+        }
+        const qint64 start = offset;
+        if (section.dirty) {
+            const QByteArray bytes = formatted.isEmpty()
+                    ? SectionFormatter{&scene}(section)
+                    : formatted.at(dirtyIndex);
+            ++dirtyIndex;
+            ok = writeBytes(bytes.constData(), bytes.size());
+        } else {
+            const ByteRange &range = m_sections[section.key];
+            ok = writeBytes(reinterpret_cast<const char*>(previousData + range.offset), range.length);
+            ++stats.reusedSections;
+            stats.reusedBytes += range.length;
+        }
+        if (offset > start) {
+            ranges.insert(section.key, ByteRange{start, offset - start});
+        }
+    }
+
+    const QByteArray footer = SceneSerializer::escFooter(hasEntities);
+    ok = ok && writeBytes(footer.constData(), footer.size());
+
+    if (previousData) {
+        previous.unmap(const_cast<uchar*>(previousData));
+    }
+    previous.close();
+
+    if (!ok || !file.commit()) {
+        qWarning() << "Falha ao gravar a cena:" << path << "-" << file.errorString();
+        invalidate();
+        return false;
+    }
+
+    const QFileInfo info(path);
+    m_path = path;
+    m_fileSize = info.size();
+    m_modified = info.lastModified();
+    m_sections.swap(ranges);
+
+    stats.totalBytes = offset;
+    m_stats = stats;
+    return true;
+}
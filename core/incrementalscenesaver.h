@@ -0,0 +1,51 @@
+#ifndef INCREMENTALSCENESAVER_H
+#define INCREMENTALSCENESAVER_H
+
+#include <QHash>
+#include <QString>
+#include <QDateTime>
+
+class SceneSerializer;
+
+// Save incremental do .esc.
+//
+// O documento é montado por seções (chunks de gravação, em ordem espacial e determinística),
+// e o saver lembra em que faixa de bytes cada seção ficou no último arquivo que gravou.
+// No próximo save, as seções limpas são copiadas do arquivo anterior (mapeado) e só as
+// sujas são formatadas. Se o arquivo no disco não é mais o que foi gravado (caminho, tamanho
+// ou data diferentes), canReuse() é falso e quem chama deve mandar todas as seções sujas.
+class IncrementalSceneSaver
+{
+public:
+    struct Stats
+    {
+        int sectionCount;
+        int reusedSections;
+        qint64 reusedBytes;
+        qint64 totalBytes;
+    };
+
+    IncrementalSceneSaver();
+
+    bool canReuse(const QString &path) const;
+    // Falha (e esquece o arquivo anterior) se uma seção limpa não puder ser reaproveitada
+    bool save(const QString &path, const SceneSerializer &scene);
+    void invalidate();
+
+    const Stats &lastStats() const { return m_stats; }
+
+private:
+    struct ByteRange
+    {
+        qint64 offset;
+        qint64 length;
+    };
+
+    QString m_path;
+    qint64 m_fileSize;
+    QDateTime m_modified;
+    QHash<quint64, ByteRange> m_sections;
+    Stats m_stats;
+};
+
+#endif // INCREMENTALSCENESAVER_H
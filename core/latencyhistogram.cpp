@@ -0,0 +1,156 @@
+#include "latencyhistogram.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QtAlgorithms>
+#include <QtMath>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<quint64> &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_totalNsecs.store(0, std::memory_order_relaxed);
+    m_maxNsecs.store(0, std::memory_order_relaxed);
+}
+
+// Bucket 0 para menos de 1 µs; depois, 4 buckets por potência de 2 pelos dois bits
+// seguintes ao bit mais alto
+int LatencyHistogram::bucketFor(qint64 usecs)
+{
+    if (usecs < 1) {
+        return 0;
+    }
+    int exponent = 63 - qCountLeadingZeroBits(static_cast<quint64>(usecs));
+    if (exponent >= MaxExponent) {
+        return BucketCount - 1;
+    }
+    const int sub = exponent >= 2 ? static_cast<int>((usecs >> (exponent - 2)) & 3)
+                                  : static_cast<int>((usecs << (2 - exponent)) & 3);
+    return 1 + exponent * SubBuckets + sub;
+}
+
+qreal LatencyHistogram::bucketUpperBoundUsecs(int index)
+{
+    if (index <= 0) {
+        return 1;
+    }
+    const int exponent = (index - 1) / SubBuckets;
+    const int sub = (index - 1) % SubBuckets;
+    return (SubBuckets + sub + 1) * qPow(2, exponent) / SubBuckets;
+}
+
+void LatencyHistogram::record(qint64 nsecs)
+{
+    m_buckets[bucketFor(nsecs / 1000)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalNsecs.fetch_add(nsecs, std::memory_order_relaxed);
+    qint64 max = m_maxNsecs.load(std::memory_order_relaxed);
+    while (nsecs > max && !m_maxNsecs.compare_exchange_weak(max, nsecs, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 LatencyHistogram::meanNsecs() const
+{
+    const quint64 n = count();
+    return n > 0 ? m_totalNsecs.load(std::memory_order_relaxed) / static_cast<qint64>(n) : 0;
+}
+
+qint64 LatencyHistogram::percentileNsecs(qreal percentile) const
+{
+    const quint64 n = count();
+    if (n == 0) {
+        return 0;
+    }
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(qCeil(percentile / 100.0 * n)));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return qMin(static_cast<qint64>(bucketUpperBoundUsecs(i) * 1000), maxNsecs());
+        }
+    }
+    return maxNsecs();
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    QJsonObject object;
+    object.insert("count", static_cast<qint64>(count()));
+    object.insert("mean_us", meanNsecs() / 1000.0);
+    object.insert("p50_us", percentileNsecs(50) / 1000.0);
+    object.insert("p90_us", percentileNsecs(90) / 1000.0);
+    object.insert("p99_us", percentileNsecs(99) / 1000.0);
+    object.insert("max_us", maxNsecs() / 1000.0);
+
+    // Só os buckets com amostras, como [limite superior em µs, contagem]
+    QJsonArray buckets;
+    for (int i = 0; i < BucketCount; ++i) {
+        const quint64 bucketCount = m_buckets[i].load(std::memory_order_relaxed);
+        if (bucketCount > 0) {
+            buckets.append(QJsonArray { bucketUpperBoundUsecs(i), static_cast<qint64>(bucketCount) });
+        }
+    }
+    object.insert("buckets", buckets);
+    return object;
+}
+
+CommandLatencies &CommandLatencies::instance()
+{
+    static CommandLatencies latencies;
+    return latencies;
+}
+
+LatencyHistogram &CommandLatencies::histogram(const QString &command)
+{
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<LatencyHistogram> &histogram = m_histograms[command];
+    if (!histogram) {
+        histogram = std::make_shared<LatencyHistogram>();
+    }
+    return *histogram;
+}
+
+QStringList CommandLatencies::commands() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_histograms.keys();
+}
+
+void CommandLatencies::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (const std::shared_ptr<LatencyHistogram> &histogram : m_histograms) {
+        histogram->reset();
+    }
+}
+
+QJsonObject CommandLatencies::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonObject commands;
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        commands.insert(it.key(), it.value()->toJson());
+    }
+    QJsonObject root;
+    root.insert("commands", commands);
+    return root;
+}
+
+bool CommandLatencies::writeJson(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar as latências:" << path;
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    return file.commit();
+}
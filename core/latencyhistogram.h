@@ -0,0 +1,88 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+
+// Histograma de latência com buckets fixos em escala logarítmica.
+//
+// Cada potência de 2 de microssegundos tem SubBuckets buckets, então um percentil sai com
+// no máximo 25% de erro para cima; o máximo é exato. record() são alguns incrementos
+// atômicos relaxados, sem alocação, e pode ser chamado de qualquer thread.
+class LatencyHistogram
+{
+public:
+    static constexpr int SubBuckets = 4;
+    static constexpr int MaxExponent = 36;     // 2^36 µs, perto de 19 horas
+    static constexpr int BucketCount = 1 + MaxExponent * SubBuckets;
+
+    LatencyHistogram();
+
+    void record(qint64 nsecs);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    qint64 maxNsecs() const { return m_maxNsecs.load(std::memory_order_relaxed); }
+    qint64 meanNsecs() const;
+    // Limite superior do bucket que contém o percentil (0-100), nunca acima do máximo
+    qint64 percentileNsecs(qreal percentile) const;
+
+    QJsonObject toJson() const;
+
+    static int bucketFor(qint64 usecs);
+    static qreal bucketUpperBoundUsecs(int index);
+
+private:
+    std::atomic<quint64> m_buckets[BucketCount];
+    std::atomic<quint64> m_count;
+    std::atomic<qint64> m_totalNsecs;
+    std::atomic<qint64> m_maxNsecs;
+};
+
+// Histogramas por comando do editor, criados na primeira vez que o comando roda.
+class CommandLatencies
+{
+public:
+    static CommandLatencies &instance();
+
+    // A referência vale até o fim do programa; o COMMAND_LATENCY a guarda numa estática local
+    LatencyHistogram &histogram(const QString &command);
+    QStringList commands() const;
+    void reset();
+
+    QJsonObject toJson() const;
+    bool writeJson(const QString &path) const;
+
+private:
+    CommandLatencies() = default;
+
+    mutable QMutex m_mutex;
+    QMap<QString, std::shared_ptr<LatencyHistogram>> m_histograms;
+};
+
+// Mede do construtor ao fim do escopo
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram &histogram) : m_histogram(histogram) { m_timer.start(); }
+    ~ScopedLatency() { m_histogram.record(m_timer.nsecsElapsed()); }
+
+private:
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+    LatencyHistogram &m_histogram;
+    QElapsedTimer m_timer;
+};
+
+#define COMMAND_LATENCY(command) \
+    static LatencyHistogram &commandLatencyHistogram = CommandLatencies::instance().histogram(command); \
+    ScopedLatency commandLatencyScope(commandLatencyHistogram)
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,457 @@
+#include "placementstore.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Mantém as coordenadas de célula longe dos limites de int (retângulos enormes nas consultas)
+const int CellCoordinateLimit = 1 << 30;
+
+qreal distanceToRect(const QPointF &pos, const QRectF &rect)
+{
+    const qreal dx = qMax(qMax(rect.left() - pos.x(), pos.x() - rect.right()), 0.0);
+    const qreal dy = qMax(qMax(rect.top() - pos.y(), pos.y() - rect.bottom()), 0.0);
+    return qSqrt(dx * dx + dy * dy);
+}
+
+}
+
+PlacementStore::PlacementStore(qreal cellSize)
+    : m_cellSize(cellSize > 0 ? cellSize : DefaultCellSize),
+      m_indexSuspended(false),
+      m_nextId(1),
+      m_count(0),
+      m_nextSequence(0),
+      m_allDirty(true)
+{
+}
+
+PlacementStore::Handle PlacementStore::add(Entity *entity, int tileIndex, const QPointF &pos, const QSizeF &size, quint64 id,
+                                           quint32 sequence)
+{
+    if (!entity || (id != InvalidId && m_idToHandle.contains(id))) {
+        return InvalidHandle;
+    }
+    if (id == InvalidId) {
+        id = m_nextId++;
+    } else if (id >= m_nextId) {
+        m_nextId = id + 1;
+    }
+    if (sequence == NextSequence) {
+        sequence = m_nextSequence++;
+    } else if (sequence >= m_nextSequence) {
+        m_nextSequence = sequence + 1;
+    }
+
+    Handle handle;
+    if (!m_freeSlots.isEmpty()) {
+        handle = m_freeSlots.takeLast();
+    } else {
+        handle = m_slots.size();
+        m_slots.append(EntityPlacement());
+    }
+
+    EntityPlacement &placement = m_slots[handle];
+    placement.id = id;
+    placement.entity = entity;
+    placement.tileIndex = tileIndex;
+    placement.x = static_cast<float>(pos.x());
+    placement.y = static_cast<float>(pos.y());
+    placement.width = static_cast<float>(size.width());
+    placement.height = static_cast<float>(size.height());
+    placement.sequence = sequence;
+    placement.selected = false;
+    ++m_count;
+    markChunkDirty(placement);
+    m_idToHandle.insert(id, handle);
+    if (!m_indexSuspended) {
+        insertIntoGrid(handle);
+    }
+
+    m_bounds = m_bounds.isNull() ? placement.rect() : m_bounds.united(placement.rect());
+    return handle;
+}
+
+void PlacementStore::remove(Handle handle)
+{
+    if (!isValid(handle)) {
+        return;
+    }
+    if (!m_indexSuspended) {
+        removeFromGrid(handle);
+    }
+    markChunkDirty(m_slots[handle]);
+    m_idToHandle.remove(m_slots[handle].id);
+    m_slots[handle].id = InvalidId;
+    m_slots[handle].entity = nullptr;
+    m_slots[handle].selected = false;
+    m_freeSlots.append(handle);
+    --m_count;
+}
+
+void PlacementStore::move(Handle handle, const QPointF &pos)
+{
+    if (!isValid(handle)) {
+        return;
+    }
+    if (!m_indexSuspended) {
+        removeFromGrid(handle);
+    }
+    EntityPlacement &placement = m_slots[handle];
+    markChunkDirty(placement);
+    placement.x = static_cast<float>(pos.x());
+    placement.y = static_cast<float>(pos.y());
+    markChunkDirty(placement);
+    if (!m_indexSuspended) {
+        insertIntoGrid(handle);
+    }
+    m_bounds = m_bounds.united(placement.rect());
+}
+
+void PlacementStore::clear()
+{
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_cells.clear();
+    m_oversized.clear();
+    m_idToHandle.clear();
+    m_nextId = 1;
+    m_count = 0;
+    m_nextSequence = 0;
+    m_bounds = QRectF();
+    m_dirtyChunks.clear();
+    m_allDirty = true;
+}
+
+void PlacementStore::reserve(int count)
+{
+    m_slots.reserve(count);
+    m_idToHandle.reserve(count);
+}
+
+void PlacementStore::suspendIndexing()
+{
+    m_indexSuspended = true;
+}
+
+void PlacementStore::resumeIndexing()
+{
+    if (!m_indexSuspended) {
+        return;
+    }
+    m_indexSuspended = false;
+    rebuildGrid();
+}
+
+quint64 PlacementStore::saveChunkKey(const QPointF &pos)
+{
+    // Inverter o bit de sinal faz a comparação sem sinal das chaves seguir a ordem (linha, coluna)
+    const quint32 column = static_cast<quint32>(qFloor(pos.x() / SaveChunkSize)) ^ 0x80000000u;
+    const quint32 row = static_cast<quint32>(qFloor(pos.y() / SaveChunkSize)) ^ 0x80000000u;
+    return (static_cast<quint64>(row) << 32) | column;
+}
+
+void PlacementStore::markAllDirty()
+{
+    m_allDirty = true;
+    m_dirtyChunks.clear();
+}
+
+void PlacementStore::markClean()
+{
+    m_allDirty = false;
+    m_dirtyChunks.clear();
+}
+
+void PlacementStore::markChunkDirty(const EntityPlacement &placement)
+{
+    // Com tudo sujo (cena nova ou importação em massa) não há o que anotar
+    if (!m_allDirty) {
+        m_dirtyChunks.insert(saveChunkKey(placement.pos()));
+    }
+}
+
+bool PlacementStore::isValid(Handle handle) const
+{
+    return handle >= 0 && handle < m_slots.size() && m_slots[handle].entity != nullptr;
+}
+
+void PlacementStore::setSelected(Handle handle, bool selected)
+{
+    if (isValid(handle)) {
+        m_slots[handle].selected = selected;
+    }
+}
+
+void PlacementStore::clearSelection()
+{
+    for (EntityPlacement &placement : m_slots) {
+        placement.selected = false;
+    }
+}
+
+QVector<PlacementStore::Handle> PlacementStore::selectedHandles() const
+{
+    QVector<Handle> result;
+    for (Handle handle = 0; handle < m_slots.size(); ++handle) {
+        if (m_slots[handle].entity && m_slots[handle].selected) {
+            result.append(handle);
+        }
+    }
+    sortBySequence(result);
+    return result;
+}
+
+PlacementStore::Handle PlacementStore::topmostAt(const QPointF &pos) const
+{
+    Handle best = InvalidHandle;
+    auto consider = [&](Handle handle) {
+        const EntityPlacement &placement = m_slots[handle];
+        if (placement.rect().contains(pos)
+            && (best == InvalidHandle || placement.sequence > m_slots[best].sequence)) {
+            best = handle;
+        }
+    };
+
+    // contains() inclui a borda direita e a inferior, que não entram na grade: um ponto em cima
+    // da linha entre duas células olha as duas
+    for (int row = endCellCoordinate(pos.y()); row <= cellCoordinate(pos.y()); ++row) {
+        for (int column = endCellCoordinate(pos.x()); column <= cellCoordinate(pos.x()); ++column) {
+            const auto cell = m_cells.constFind(cellKey(column, row));
+            if (cell != m_cells.constEnd()) {
+                for (Handle handle : *cell) {
+                    consider(handle);
+                }
+            }
+        }
+    }
+    for (Handle handle : m_oversized) {
+        consider(handle);
+    }
+    return best;
+}
+
+PlacementStore::Handle PlacementStore::nearest(const QPointF &pos, qreal maxDistance) const
+{
+    Handle best = InvalidHandle;
+    qreal bestDistance = maxDistance;
+    auto consider = [&](Handle handle) {
+        const EntityPlacement &placement = m_slots[handle];
+        const qreal distance = distanceToRect(pos, placement.rect());
+        if (distance < bestDistance
+            || (distance == bestDistance
+                && (best == InvalidHandle || placement.sequence > m_slots[best].sequence))) {
+            best = handle;
+            bestDistance = distance;
+        }
+    };
+
+    const int column = cellCoordinate(pos.x());
+    const int row = cellCoordinate(pos.y());
+    const int maxRing = qMin(qCeil(maxDistance / m_cellSize), CellCoordinateLimit);
+    const qint64 side = 2 * static_cast<qint64>(maxRing) + 1;
+
+    if (side * side > m_cells.size()) {
+        // Raio maior que a grade ocupada: percorrer as células existentes sai mais barato
+        for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it) {
+            if (qAbs(keyColumn(it.key()) - column) <= maxRing && qAbs(keyRow(it.key()) - row) <= maxRing) {
+                for (Handle handle : it.value()) {
+                    consider(handle);
+                }
+            }
+        }
+    } else {
+        // Anéis de células em volta do ponto; o anel n está a pelo menos (n - 1) * cellSize
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            if (best != InvalidHandle && (ring - 1) * m_cellSize > bestDistance) {
+                break;
+            }
+            for (int r = row - ring; r <= row + ring; ++r) {
+                const bool edgeRow = (r == row - ring || r == row + ring);
+                const int step = edgeRow ? 1 : 2 * ring;
+                for (int c = column - ring; c <= column + ring; c += step) {
+                    const auto cell = m_cells.constFind(cellKey(c, r));
+                    if (cell != m_cells.constEnd()) {
+                        for (Handle handle : *cell) {
+                            consider(handle);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (Handle handle : m_oversized) {
+        consider(handle);
+    }
+    return best;
+}
+
+QVector<PlacementStore::Handle> PlacementStore::handlesIn(const QRectF &rect) const
+{
+    QVector<Handle> result;
+    if (!rect.isValid()) {
+        return result;
+    }
+
+    const CellRange range = cellRange(rect);
+    if (static_cast<qint64>(range.columns()) * range.rows() > m_cells.size()) {
+        // Consulta maior que a grade ocupada (zoom out): percorrer as células existentes
+        for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it) {
+            const int column = keyColumn(it.key());
+            const int row = keyRow(it.key());
+            if (column >= range.left && column <= range.right && row >= range.top && row <= range.bottom) {
+                collectFromCell(column, row, it.value(), range, rect, result);
+            }
+        }
+    } else {
+        for (int row = range.top; row <= range.bottom; ++row) {
+            for (int column = range.left; column <= range.right; ++column) {
+                const auto cell = m_cells.constFind(cellKey(column, row));
+                if (cell != m_cells.constEnd()) {
+                    collectFromCell(column, row, *cell, range, rect, result);
+                }
+            }
+        }
+    }
+
+    for (Handle handle : m_oversized) {
+        if (m_slots[handle].rect().intersects(rect)) {
+            result.append(handle);
+        }
+    }
+    sortBySequence(result);
+    return result;
+}
+
+QVector<PlacementStore::Handle> PlacementStore::handles() const
+{
+    QVector<Handle> result;
+    result.reserve(m_count);
+    for (Handle handle = 0; handle < m_slots.size(); ++handle) {
+        if (m_slots[handle].entity) {
+            result.append(handle);
+        }
+    }
+    sortBySequence(result);
+    return result;
+}
+
+qint64 PlacementStore::memoryBytes() const
+{
+    // Nó do QHash estimado como chave + QVector + ponteiro de encadeamento
+    qint64 gridBytes = static_cast<qint64>(m_cells.capacity()) * sizeof(void *);
+    for (const QVector<Handle> &cell : m_cells) {
+        gridBytes += sizeof(quint64) + sizeof(QVector<Handle>) + sizeof(void *)
+                     + static_cast<qint64>(cell.capacity()) * sizeof(Handle);
+    }
+    return static_cast<qint64>(m_slots.capacity()) * sizeof(EntityPlacement)
+           + static_cast<qint64>(m_freeSlots.capacity()) * sizeof(Handle)
+           + static_cast<qint64>(m_oversized.capacity()) * sizeof(Handle)
+           + static_cast<qint64>(m_idToHandle.size()) * (sizeof(quint64) + sizeof(Handle) + sizeof(void *))
+           + gridBytes;
+}
+
+int PlacementStore::cellCoordinate(qreal value) const
+{
+    const qreal cell = qFloor(value / m_cellSize);
+    return static_cast<int>(qBound<qreal>(-CellCoordinateLimit, cell, CellCoordinateLimit));
+}
+
+int PlacementStore::endCellCoordinate(qreal value) const
+{
+    // A borda é exclusiva: um tile de uma célula alinhado à grade termina na célula dele
+    const qreal cell = std::ceil(value / m_cellSize) - 1;
+    return static_cast<int>(qBound<qreal>(-CellCoordinateLimit, cell, CellCoordinateLimit));
+}
+
+PlacementStore::CellRange PlacementStore::cellRange(const QRectF &rect) const
+{
+    CellRange range;
+    range.left = cellCoordinate(rect.left());
+    range.top = cellCoordinate(rect.top());
+    // Retângulo de largura ou altura zero ainda ocupa a célula do canto
+    range.right = qMax(range.left, endCellCoordinate(rect.right()));
+    range.bottom = qMax(range.top, endCellCoordinate(rect.bottom()));
+    return range;
+}
+
+bool PlacementStore::isOversized(const CellRange &range) const
+{
+    return range.columns() > MaxCellsPerAxis || range.rows() > MaxCellsPerAxis;
+}
+
+void PlacementStore::insertIntoGrid(Handle handle)
+{
+    const CellRange range = cellRange(m_slots[handle].rect());
+    if (isOversized(range)) {
+        m_oversized.append(handle);
+        return;
+    }
+    for (int row = range.top; row <= range.bottom; ++row) {
+        for (int column = range.left; column <= range.right; ++column) {
+            m_cells[cellKey(column, row)].append(handle);
+        }
+    }
+}
+
+void PlacementStore::rebuildGrid()
+{
+    m_cells.clear();
+    m_oversized.clear();
+    // Chute para tiles do tamanho da célula: cerca de uma célula por colocação
+    m_cells.reserve(m_count);
+    for (Handle handle = 0; handle < m_slots.size(); ++handle) {
+        if (m_slots[handle].entity) {
+            insertIntoGrid(handle);
+        }
+    }
+}
+
+void PlacementStore::removeFromGrid(Handle handle)
+{
+    const CellRange range = cellRange(m_slots[handle].rect());
+    if (isOversized(range)) {
+        m_oversized.removeOne(handle);
+        return;
+    }
+    for (int row = range.top; row <= range.bottom; ++row) {
+        for (int column = range.left; column <= range.right; ++column) {
+            auto cell = m_cells.find(cellKey(column, row));
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            cell->removeOne(handle);
+            if (cell->isEmpty()) {
+                m_cells.erase(cell);
+            }
+        }
+    }
+}
+
+void PlacementStore::collectFromCell(int column, int row, const QVector<Handle> &cell,
+                                     const CellRange &queryRange, const QRectF &rect,
+                                     QVector<Handle> &result) const
+{
+    for (Handle handle : cell) {
+        const EntityPlacement &placement = m_slots[handle];
+        // Uma colocação que ocupa várias células só é reportada pela primeira célula em
+        // comum com a consulta, sem precisar de um conjunto para remover duplicatas
+        const CellRange placementRange = cellRange(placement.rect());
+        if (column != qMax(placementRange.left, queryRange.left)
+            || row != qMax(placementRange.top, queryRange.top)) {
+            continue;
+        }
+        if (placement.rect().intersects(rect)) {
+            result.append(handle);
+        }
+    }
+}
+
+void PlacementStore::sortBySequence(QVector<Handle> &handles) const
+{
+    std::sort(handles.begin(), handles.end(), [this](Handle a, Handle b) {
+        return m_slots[a].sequence < m_slots[b].sequence;
+    });
+}
@@ -0,0 +1,161 @@
+#ifndef PLACEMENTSTORE_H
+#define PLACEMENTSTORE_H
+
+#include <QVector>
+#include <QHash>
+#include <QPointF>
+#include <QSizeF>
+#include <QRectF>
+#include <QSet>
+
+class Entity;
+
+// Uma entidade colocada na cena. Guardada de forma compacta (floats, sem QGraphicsItem):
+// a camada TileLayerItem desenha todas as colocações direto a partir daqui.
+struct EntityPlacement
+{
+    quint64 id;           // Estável durante a vida da cena; 0 = slot livre
+    Entity *entity;       // nullptr = slot livre
+    qint32 tileIndex;
+    float x;              // Canto superior esquerdo, como QGraphicsItem::pos()
+    float y;
+    float width;
+    float height;
+    quint32 sequence;     // Ordem de empilhamento: maior é desenhado por cima
+    bool selected;
+
+    QPointF pos() const { return QPointF(x, y); }
+    QSizeF size() const { return QSizeF(width, height); }
+    QRectF rect() const { return QRectF(x, y, width, height); }
+};
+
+// Armazenamento das colocações da cena em slots estáveis.
+//
+// Um handle é o índice do slot e continua válido até a colocação ser removida;
+// slots livres são reaproveitados, então a ordem de desenho vem de EntityPlacement::sequence.
+// Quem precisa guardar uma referência além disso (undo/redo) usa o id, que sobrevive à
+// remoção: add() com o id e a sequence antigos recoloca a mesma colocação.
+//
+// As consultas espaciais passam por uma grade uniforme (hash de células de cellSize pixels),
+// mantida em add/remove/move: o custo depende de quantas colocações há perto da consulta,
+// não do total da cena.
+//
+// Para o save incremental, a cena também é dividida em chunks de gravação (SaveChunkSize
+// pixels, pelo canto superior esquerdo); add/remove/move marcam os chunks que tocam como sujos
+// até markClean().
+class PlacementStore
+{
+public:
+    typedef int Handle;
+    static constexpr Handle InvalidHandle = -1;
+    static constexpr quint64 InvalidId = 0;
+    // Em add(): a colocação vai para cima de todas
+    static constexpr quint32 NextSequence = 0xffffffffu;
+    static constexpr qreal DefaultCellSize = 64.0;
+    // Colocações que cobrem mais células que isso por eixo ficam numa lista à parte
+    static constexpr int MaxCellsPerAxis = 16;
+    static constexpr qreal SaveChunkSize = 1024.0;
+
+    explicit PlacementStore(qreal cellSize = DefaultCellSize);
+
+    // id == InvalidId gera um id novo; um id já em uso faz add() falhar. O undo de uma remoção
+    // passa o id e a sequence antigos, e a colocação volta para o mesmo lugar na pilha
+    Handle add(Entity *entity, int tileIndex, const QPointF &pos, const QSizeF &size, quint64 id = InvalidId,
+               quint32 sequence = NextSequence);
+    void remove(Handle handle);
+    void move(Handle handle, const QPointF &pos);
+    void clear();
+    void reserve(int count);
+
+    // Inserção em massa: com o índice suspenso, add/remove/move não mexem na grade e
+    // as consultas espaciais ficam indefinidas até resumeIndexing() reconstruí-la de uma vez
+    void suspendIndexing();
+    void resumeIndexing();
+    bool isIndexingSuspended() const { return m_indexSuspended; }
+
+    bool isValid(Handle handle) const;
+    Handle handleForId(quint64 id) const { return m_idToHandle.value(id, InvalidHandle); }
+    const EntityPlacement &at(Handle handle) const { return m_slots[handle]; }
+    int count() const { return m_count; }
+
+    // Retângulo que contém todas as colocações já feitas desde o último clear()
+    QRectF boundingRect() const { return m_bounds; }
+
+    void setSelected(Handle handle, bool selected);
+    void clearSelection();
+    QVector<Handle> selectedHandles() const;
+
+    // Colocação desenhada por cima no ponto, ou InvalidHandle
+    Handle topmostAt(const QPointF &pos) const;
+    // Colocação cujo retângulo está mais perto do ponto (0 se o contém), até maxDistance
+    Handle nearest(const QPointF &pos, qreal maxDistance) const;
+    // Colocações que intersectam o retângulo, da mais baixa para a mais alta
+    QVector<Handle> handlesIn(const QRectF &rect) const;
+    // Todas as colocações, da mais baixa para a mais alta
+    QVector<Handle> handles() const;
+
+    // Bytes ocupados pelos slots (inclui os livres) e pela grade
+    qint64 memoryBytes() const;
+
+    qreal cellSize() const { return m_cellSize; }
+    int occupiedCellCount() const { return m_cells.size(); }
+
+    // Chave do chunk de gravação; a ordem das chaves é a de linha e depois coluna
+    static quint64 saveChunkKey(const QPointF &pos);
+    bool isDirty() const { return m_allDirty || !m_dirtyChunks.isEmpty(); }
+    bool isChunkDirty(quint64 key) const { return m_allDirty || m_dirtyChunks.contains(key); }
+    int dirtyChunkCount() const { return m_dirtyChunks.size(); }
+    // Depois de clear() tudo está sujo, até o primeiro save completo
+    void markAllDirty();
+    void markClean();
+
+private:
+    struct CellRange
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+
+        int columns() const { return right - left + 1; }
+        int rows() const { return bottom - top + 1; }
+    };
+
+    static quint64 cellKey(int column, int row)
+    {
+        return (static_cast<quint64>(static_cast<quint32>(column)) << 32) | static_cast<quint32>(row);
+    }
+    static int keyColumn(quint64 key) { return static_cast<qint32>(key >> 32); }
+    static int keyRow(quint64 key) { return static_cast<qint32>(key & 0xffffffffu); }
+
+    int cellCoordinate(qreal value) const;
+    // Célula de uma borda direita ou inferior
+    int endCellCoordinate(qreal value) const;
+    CellRange cellRange(const QRectF &rect) const;
+    bool isOversized(const CellRange &range) const;
+    void insertIntoGrid(Handle handle);
+    void rebuildGrid();
+    void removeFromGrid(Handle handle);
+    void collectFromCell(int column, int row, const QVector<Handle> &cell,
+                         const CellRange &queryRange, const QRectF &rect, QVector<Handle> &result) const;
+    void sortBySequence(QVector<Handle> &handles) const;
+    void markChunkDirty(const EntityPlacement &placement);
+
+    qreal m_cellSize;
+    QHash<quint64, QVector<Handle>> m_cells;
+    QVector<Handle> m_oversized;
+    bool m_indexSuspended;
+
+    QVector<EntityPlacement> m_slots;
+    QVector<Handle> m_freeSlots;
+    QHash<quint64, Handle> m_idToHandle;
+    quint64 m_nextId;
+    int m_count;
+    quint32 m_nextSequence;
+    QRectF m_bounds;
+
+    QSet<quint64> m_dirtyChunks;
+    bool m_allDirty;
+};
+
+#endif // PLACEMENTSTORE_H
@@ -0,0 +1,748 @@
+#include "scenemodel.h"
+#include "entity.h"
+#include "entitymanager.h"
+#include "sceneserializer.h"
+#include "binaryscenefile.h"
+#include "tracerecorder.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QXmlStreamReader>
+#include <algorithm>
+
+namespace {
+
+// Mudança que um undo aplica de fato na cena, para o journal
+UndoAction inverseAction(const UndoAction &action)
+{
+    UndoAction inverse = action;
+    switch (action.type) {
+    case UndoAction::ADD:
+        inverse.type = UndoAction::REMOVE;
+        inverse.oldPos = action.newPos;
+        break;
+    case UndoAction::REMOVE:
+        inverse.type = UndoAction::ADD;
+        inverse.newPos = action.oldPos;
+        break;
+    case UndoAction::MOVE:
+        inverse.oldPos = action.newPos;
+        inverse.newPos = action.oldPos;
+        break;
+    }
+    return inverse;
+}
+
+// Entidade de um nome do arquivo, resolvida uma vez por importação
+struct ResolvedEntity
+{
+    Entity *entity;
+    QSizeF size;
+    int spriteCount;
+};
+
+ResolvedEntity resolveEntity(EntityManager *entityManager, const QString &name)
+{
+    ResolvedEntity entry = { entityManager->getEntityByName(name), QSizeF(), 0 };
+    if (entry.entity) {
+        entry.size = SceneModel::placementSize(entry.entity);
+        entry.spriteCount = entry.entity->getSpriteDefinitions().size();
+    }
+    return entry;
+}
+
+}
+
+SceneModel::SceneModel(EntityManager *entityManager, QObject *parent)
+    : QObject(parent),
+      m_entityManager(entityManager),
+      m_journalEnabled(true),
+      m_modified(false)
+{
+}
+
+QSizeF SceneModel::placementSize(const Entity *entity)
+{
+    QSizeF size = entity->getCurrentSize();
+    if (size.isEmpty()) {
+        size = entity->getCollisionSize();
+        if (size.isEmpty()) {
+            size = QSizeF(32, 32);
+        }
+    }
+    return size;
+}
+
+QPointF SceneModel::snapToEntityGrid(const QPointF &pos, const QSizeF &size)
+{
+    return QPointF(qRound(pos.x() / size.width()) * size.width(),
+                   qRound(pos.y() / size.height()) * size.height());
+}
+
+int SceneModel::addPlacement(Entity *entity, int tileIndex, const QPointF &pos, bool record, quint64 placementId,
+                             quint32 sequence)
+{
+    if (!entity) {
+        return PlacementStore::InvalidHandle;
+    }
+
+    const int handle = m_placements.add(entity, tileIndex, pos, placementSize(entity), placementId, sequence);
+    if (handle == PlacementStore::InvalidHandle) {
+        qWarning() << "Id de colocação já em uso:" << placementId;
+        return PlacementStore::InvalidHandle;
+    }
+    entity->addPlacementRef();
+
+    const EntityPlacement &placement = m_placements.at(handle);
+    if (record) {
+        Action action;
+        action.type = Action::ADD;
+        action.entity = entity;
+        action.tileIndex = tileIndex;
+        action.newPos = placement.pos();
+        action.placementId = placement.id;
+        action.sequence = PlacementStore::NextSequence;
+        this->record(action);
+    }
+    m_modified = true;
+    emit placementsChanged(placement.rect());
+    return handle;
+}
+
+void SceneModel::removePlacement(int handle, bool record)
+{
+    if (!m_placements.isValid(handle)) {
+        return;
+    }
+
+    const EntityPlacement &placement = m_placements.at(handle);
+    const QRectF area = placement.rect();
+    if (record) {
+        Action action;
+        action.type = Action::REMOVE;
+        action.entity = placement.entity;
+        action.tileIndex = placement.tileIndex;
+        action.oldPos = placement.pos();
+        action.placementId = placement.id;
+        action.sequence = placement.sequence;
+        this->record(action);
+    }
+    placement.entity->releasePlacementRef();
+    m_placements.remove(handle);
+
+    m_modified = true;
+    emit placementRemoved(handle);
+    emit placementsChanged(area);
+}
+
+void SceneModel::removePlacements(const QVector<int> &handles)
+{
+    beginStep();
+    for (int handle : handles) {
+        removePlacement(handle);
+    }
+    endStep();
+}
+
+void SceneModel::movePlacement(int handle, const QPointF &pos, bool record)
+{
+    if (!m_placements.isValid(handle)) {
+        return;
+    }
+
+    const QRectF oldArea = m_placements.at(handle).rect();
+    const QPointF oldPos = m_placements.at(handle).pos();
+    m_placements.move(handle, pos);
+
+    const EntityPlacement &placement = m_placements.at(handle);
+    if (record) {
+        Action action;
+        action.type = Action::MOVE;
+        action.entity = placement.entity;
+        action.tileIndex = placement.tileIndex;
+        action.oldPos = oldPos;
+        action.newPos = placement.pos();
+        action.placementId = placement.id;
+        action.sequence = PlacementStore::NextSequence;
+        this->record(action);
+    }
+    m_modified = true;
+    emit placementsChanged(oldArea.united(placement.rect()));
+}
+
+void SceneModel::recordMoves(const QVector<int> &handles, const QVector<QPointF> &oldPositions)
+{
+    beginStep();
+    for (int i = 0; i < handles.size() && i < oldPositions.size(); ++i) {
+        if (!m_placements.isValid(handles[i])) {
+            continue;
+        }
+        const EntityPlacement &placement = m_placements.at(handles[i]);
+        Action action;
+        action.type = Action::MOVE;
+        action.entity = placement.entity;
+        action.tileIndex = placement.tileIndex;
+        action.oldPos = oldPositions[i];
+        action.newPos = placement.pos();
+        action.placementId = placement.id;
+        action.sequence = PlacementStore::NextSequence;
+        record(action);
+        m_modified = true;
+    }
+    endStep();
+}
+
+int SceneModel::eraseTarget(const QRectF &eraseRect, qreal *overlapRatio) const
+{
+    int target = PlacementStore::InvalidHandle;
+    qreal maxOverlapRatio = 0;
+    const qreal eraseArea = eraseRect.width() * eraseRect.height();
+    if (eraseArea <= 0) {
+        return target;
+    }
+
+    // handlesIn() vem de baixo para cima: em caso de empate, a de cima é apagada
+    for (int handle : m_placements.handlesIn(eraseRect)) {
+        const QRectF intersection = eraseRect.intersected(m_placements.at(handle).rect());
+        const qreal ratio = intersection.width() * intersection.height() / eraseArea;
+        if (ratio > EraseOverlapThreshold && ratio >= maxOverlapRatio) {
+            maxOverlapRatio = ratio;
+            target = handle;
+        }
+    }
+
+    if (overlapRatio) {
+        *overlapRatio = maxOverlapRatio;
+    }
+    return target;
+}
+
+void SceneModel::beginStep()
+{
+    m_history.beginStep();
+    m_journal.beginStep();
+}
+
+void SceneModel::endStep()
+{
+    m_history.endStep();
+    m_journal.endStep();
+    if (!m_history.isRecordingStep()) {
+        emit historyChanged();
+    }
+}
+
+void SceneModel::record(const Action &action)
+{
+    if (action.type == Action::MOVE && action.oldPos == action.newPos) {
+        return;
+    }
+    m_history.record(action);
+    m_journal.record(action);
+    if (!m_history.isRecordingStep()) {
+        emit historyChanged();
+    }
+}
+
+bool SceneModel::undo()
+{
+    if (!m_history.canUndo()) {
+        return false;
+    }
+    TraceSpan span("SceneModel::undo", "edit");
+    const QVector<Action> step = m_history.takeUndoStep();
+    span.addArg("actions", step.size());
+    const bool performed = applyStep(step, true);
+    emit historyChanged();
+    return performed;
+}
+
+bool SceneModel::redo()
+{
+    if (!m_history.canRedo()) {
+        return false;
+    }
+    TraceSpan span("SceneModel::redo", "edit");
+    const QVector<Action> step = m_history.takeRedoStep();
+    span.addArg("actions", step.size());
+    const bool performed = applyStep(step, false);
+    emit historyChanged();
+    return performed;
+}
+
+bool SceneModel::applyStep(const QVector<Action> &actions, bool undo)
+{
+    bool performed = false;
+
+    // Um passo é desfeito de trás para frente; no journal entra o que foi aplicado de fato
+    m_journal.beginStep();
+    for (int i = 0; i < actions.size(); ++i) {
+        const Action &recorded = actions.at(undo ? actions.size() - 1 - i : i);
+        if (!recorded.entity) {
+            qWarning() << "Ação inválida encontrada no histórico";
+            continue;
+        }
+        const Action action = undo ? inverseAction(recorded) : recorded;
+
+        bool applied = false;
+        switch (action.type) {
+        case Action::ADD:
+            applied = addPlacement(action.entity, action.tileIndex, action.newPos, false, action.placementId,
+                                   action.sequence) != PlacementStore::InvalidHandle;
+            break;
+        case Action::REMOVE: {
+            const int handle = m_placements.handleForId(action.placementId);
+            if (handle != PlacementStore::InvalidHandle) {
+                removePlacement(handle, false);
+                applied = true;
+            }
+            break;
+        }
+        case Action::MOVE: {
+            const int handle = m_placements.handleForId(action.placementId);
+            if (handle != PlacementStore::InvalidHandle) {
+                movePlacement(handle, action.newPos, false);
+                applied = true;
+            }
+            break;
+        }
+        }
+        if (applied) {
+            m_journal.record(action);
+            performed = true;
+        }
+    }
+    m_journal.endStep();
+    return performed;
+}
+
+void SceneModel::clear()
+{
+    for (int handle : m_placements.handles()) {
+        m_placements.at(handle).entity->releasePlacementRef();
+    }
+    m_placements.clear();
+    m_history.clear();
+    m_modified = false;
+    emit placementsChanged(QRectF());
+    emit historyChanged();
+}
+
+bool SceneModel::importScene(const QString &path, FileStats *stats)
+{
+    TraceSpan span("SceneModel::importScene", "io");
+    span.addArg("path", path);
+    m_errorString.clear();
+    FileStats localStats = FileStats{0, 0, 0, 0, false, 0};
+    QElapsedTimer importTimer;
+    importTimer.start();
+
+    const bool ok = path.endsWith(".escb") ? importEscb(path, localStats) : importEsc(path, localStats);
+    localStats.elapsedMs = importTimer.elapsed();
+    span.addArg("entities", localStats.entityCount);
+    span.addArg("missing", localStats.missingCount);
+    if (stats) {
+        *stats = localStats;
+    }
+    if (!ok) {
+        return false;
+    }
+
+    m_scenePath = path;
+    m_modified = false;
+    restartJournal(m_scenePath);
+    return true;
+}
+
+int SceneModel::addImported(Entity *entity, int tileIndex, const QPointF &pos, const QSizeF &size, quint64 placementId)
+{
+    // O id do arquivo é mantido, para o próximo save gravar o mesmo; repetido, ganha um novo
+    int handle = m_placements.add(entity, tileIndex, pos, size, placementId);
+    if (handle == PlacementStore::InvalidHandle && placementId != PlacementStore::InvalidId) {
+        qWarning() << "Id repetido na cena importada:" << placementId;
+        handle = m_placements.add(entity, tileIndex, pos, size);
+    }
+    if (handle != PlacementStore::InvalidHandle) {
+        entity->addPlacementRef();
+    }
+    return handle;
+}
+
+bool SceneModel::importEsc(const QString &path, FileStats &stats)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_errorString = QString("Não foi possível abrir o arquivo para leitura: %1").arg(path);
+        return false;
+    }
+
+    clear();
+
+    // Cada EntityName distinto é resolvido uma vez (inclusive os que não existem)
+    QHash<QString, ResolvedEntity> resolvedEntities;
+    QHash<QString, int> missingEntities;
+
+    // Cerca de 250 bytes por entidade no .esc
+    m_placements.reserve(static_cast<int>(file.size() / 250));
+    m_placements.suspendIndexing();
+
+    QXmlStreamReader xml(&file);
+
+    while (!xml.atEnd() && !xml.hasError()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+        if (token != QXmlStreamReader::StartElement || xml.name().compare(QLatin1String("Entity")) != 0) {
+            continue;
+        }
+
+        QString entityName;
+        QPointF position;
+        int spriteFrame = 0;
+
+        QXmlStreamAttributes attributes = xml.attributes();
+        const quint64 placementId = attributes.value(QLatin1String("id")).toULongLong();
+        if (attributes.hasAttribute(QLatin1String("spriteFrame"))) {
+            spriteFrame = attributes.value(QLatin1String("spriteFrame")).toInt();
+        }
+
+        while (!xml.atEnd() && !(xml.tokenType() == QXmlStreamReader::EndElement &&
+                                 xml.name().compare(QLatin1String("Entity")) == 0)) {
+            xml.readNext();
+
+            if (xml.tokenType() == QXmlStreamReader::StartElement) {
+                if (xml.name().compare(QLatin1String("EntityName")) == 0) {
+                    entityName = xml.readElementText().replace(QLatin1String(".ent"), QString());
+                } else if (xml.name().compare(QLatin1String("Position")) == 0) {
+                    QXmlStreamAttributes posAttributes = xml.attributes();
+                    qreal x = posAttributes.value(QLatin1String("x")).toDouble();
+                    qreal y = posAttributes.value(QLatin1String("y")).toDouble();
+                    position = QPointF(x, y);
+                }
+            }
+        }
+
+        auto resolved = resolvedEntities.constFind(entityName);
+        if (resolved == resolvedEntities.constEnd()) {
+            resolved = resolvedEntities.insert(entityName, resolveEntity(m_entityManager, entityName));
+        }
+
+        if (!resolved->entity) {
+            ++missingEntities[entityName];
+            ++stats.missingCount;
+            continue;
+        }
+
+        // A posição no arquivo é o centro
+        const QSizeF &entitySize = resolved->size;
+        const QPointF correctedPos = position - QPointF(entitySize.width() / 2, entitySize.height() / 2);
+        if (spriteFrame < 0 || spriteFrame >= resolved->spriteCount) {
+            spriteFrame = 0;
+        }
+        if (addImported(resolved->entity, spriteFrame, correctedPos, entitySize, placementId)
+            != PlacementStore::InvalidHandle) {
+            ++stats.entityCount;
+        }
+    }
+
+    // Grade espacial e view atualizadas uma vez só
+    m_placements.resumeIndexing();
+    emit placementsChanged(QRectF());
+
+    for (auto it = missingEntities.cbegin(); it != missingEntities.cend(); ++it) {
+        qWarning() << "Entidade não encontrada:" << it.key() << "(" << it.value() << "ocorrências )";
+    }
+
+    if (xml.hasError()) {
+        // O que foi lido até o erro fica na cena, como antes
+        m_errorString = QString("Erro ao ler o arquivo XML: %1").arg(xml.errorString());
+        qWarning() << m_errorString;
+    }
+    return true;
+}
+
+bool SceneModel::importEscb(const QString &path, FileStats &stats)
+{
+    BinarySceneFile binary;
+    if (!binary.open(path)) {
+        m_errorString = QString("Não foi possível abrir a cena binária: %1").arg(path);
+        return false;
+    }
+
+    clear();
+
+    // Um nome por índice da tabela do arquivo, resolvido uma vez só
+    QVector<ResolvedEntity> resolvedEntities(binary.nameCount());
+    for (int i = 0; i < binary.nameCount(); ++i) {
+        resolvedEntities[i] = resolveEntity(m_entityManager, binary.nameAt(i));
+    }
+    QVector<int> missingCounts(binary.nameCount(), 0);
+
+    m_placements.reserve(binary.recordCount());
+    m_placements.suspendIndexing();
+
+    // Mesma ordem do .esc, para a pilha de desenho sair igual à da importação em XML
+    const BinarySceneFile::EscbRecord *records = binary.records();
+    const QVector<quint32> order = binary.recordsInSequence();
+    for (quint32 index : order) {
+        const BinarySceneFile::EscbRecord &record = records[index];
+        if (record.nameIndex >= static_cast<quint32>(resolvedEntities.size())) {
+            continue;
+        }
+        const ResolvedEntity &resolved = resolvedEntities.at(static_cast<int>(record.nameIndex));
+        if (!resolved.entity) {
+            ++missingCounts[static_cast<int>(record.nameIndex)];
+            ++stats.missingCount;
+            continue;
+        }
+
+        int spriteFrame = record.spriteFrame;
+        if (spriteFrame < 0 || spriteFrame >= resolved.spriteCount) {
+            spriteFrame = 0;
+        }
+        const QPointF correctedPos(record.x - resolved.size.width() / 2, record.y - resolved.size.height() / 2);
+        if (addImported(resolved.entity, spriteFrame, correctedPos, resolved.size, record.id)
+            != PlacementStore::InvalidHandle) {
+            ++stats.entityCount;
+        }
+    }
+
+    m_placements.resumeIndexing();
+    emit placementsChanged(QRectF());
+
+    for (int i = 0; i < missingCounts.size(); ++i) {
+        if (missingCounts.at(i) > 0) {
+            qWarning() << "Entidade não encontrada:" << binary.nameAt(i) << "(" << missingCounts.at(i) << "ocorrências )";
+        }
+    }
+    return true;
+}
+
+bool SceneModel::saveScene(const QString &path, FileStats *stats)
+{
+    TraceSpan span("SceneModel::saveScene", "io");
+    span.addArg("path", path);
+    m_errorString.clear();
+    FileStats localStats = FileStats{0, 0, 0, 0, false, 0};
+    QElapsedTimer saveTimer;
+    saveTimer.start();
+
+    bool ok;
+    if (path.endsWith(".escb")) {
+        SceneSerializer serializer;
+        fillSerializer(serializer);
+        ok = BinarySceneFile::write(path, serializer);
+        if (!ok) {
+            m_errorString = QString("Não foi possível gravar a cena binária: %1").arg(path);
+        }
+        localStats.entityCount = serializer.recordCount();
+    } else {
+        ok = saveEsc(path, localStats);
+    }
+
+    localStats.elapsedMs = saveTimer.elapsed();
+    span.addArg("entities", localStats.entityCount);
+    span.addArg("reusedSections", localStats.reusedSections);
+    if (stats) {
+        *stats = localStats;
+    }
+    if (ok) {
+        m_modified = false;
+    }
+    if (ok && !localStats.skipped) {
+        m_scenePath = path;
+        restartJournal(m_scenePath);
+    }
+    return ok;
+}
+
+bool SceneModel::saveEsc(const QString &path, FileStats &stats)
+{
+    // Nada mudou desde o último save e o arquivo no disco é o mesmo que foi gravado
+    const bool reuse = m_sceneSaver.canReuse(path);
+    if (reuse && !m_placements.isDirty()) {
+        stats.skipped = true;
+        return true;
+    }
+    if (!reuse) {
+        m_placements.markAllDirty();
+    }
+
+    SceneSerializer serializer;
+    fillSerializer(serializer, true);
+    if (!m_sceneSaver.save(path, serializer)) {
+        // Arquivo anterior inutilizável: grava tudo de novo
+        m_placements.markAllDirty();
+        serializer.clear();
+        fillSerializer(serializer, true);
+        if (!m_sceneSaver.save(path, serializer)) {
+            m_errorString = QString("Não foi possível gravar a cena: %1").arg(path);
+            return false;
+        }
+    }
+    m_placements.markClean();
+
+    const IncrementalSceneSaver::Stats &saverStats = m_sceneSaver.lastStats();
+    stats.entityCount = serializer.recordCount();
+    stats.sectionCount = saverStats.sectionCount;
+    stats.reusedSections = saverStats.reusedSections;
+    return true;
+}
+
+bool SceneModel::exportScene(const QString &path, FileStats *stats)
+{
+    TraceSpan span("SceneModel::exportScene", "io");
+    span.addArg("path", path);
+    m_errorString.clear();
+    QElapsedTimer exportTimer;
+    exportTimer.start();
+
+    // Sem Text: \n em todas as plataformas, os mesmos bytes do saveScene
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_errorString = QString("Não foi possível abrir o arquivo para escrita: %1").arg(path);
+        return false;
+    }
+
+    SceneSerializer serializer;
+    fillSerializer(serializer);
+    const bool ok = serializer.writeEsc(&file);
+    if (!ok) {
+        m_errorString = QString("Não foi possível gravar a cena: %1").arg(file.errorString());
+    }
+
+    if (stats) {
+        *stats = FileStats{serializer.recordCount(), 0, 0, 0, false, exportTimer.elapsed()};
+    }
+    return ok;
+}
+
+void SceneModel::fillSerializer(SceneSerializer &serializer, bool skipCleanSections) const
+{
+    struct EntityInfo {
+        quint32 nameIndex;
+        QPointF halfSize;
+    };
+    QHash<Entity*, EntityInfo> entityInfo;
+
+    // Ordem determinística: chunks de gravação por linha e coluna e, dentro de cada um, de cima
+    // para baixo como QGraphicsScene::items() dava. Um chunk sem alteração sai com os mesmos bytes.
+    const QVector<int> handles = m_placements.handles();
+    QHash<quint64, QVector<int>> chunks;
+    for (auto handleIt = handles.crbegin(); handleIt != handles.crend(); ++handleIt) {
+        chunks[PlacementStore::saveChunkKey(m_placements.at(*handleIt).pos())].append(*handleIt);
+    }
+    QVector<quint64> chunkKeys = chunks.keys().toVector();
+    std::sort(chunkKeys.begin(), chunkKeys.end());
+
+    serializer.reserve(handles.size());
+    for (quint64 key : chunkKeys) {
+        const bool dirty = !skipCleanSections || m_placements.isChunkDirty(key);
+        serializer.beginSection(key, dirty);
+        if (!dirty) {
+            continue;
+        }
+
+        for (int handle : chunks.value(key)) {
+            const EntityPlacement &placement = m_placements.at(handle);
+
+            auto info = entityInfo.constFind(placement.entity);
+            if (info == entityInfo.constEnd()) {
+                // A posição gravada é o centro, pelo tamanho atual da entidade
+                const QSizeF entitySize = placementSize(placement.entity);
+                EntityInfo entry = { serializer.internName(placement.entity->getName()),
+                                     QPointF(entitySize.width() / 2, entitySize.height() / 2) };
+                info = entityInfo.insert(placement.entity, entry);
+            }
+
+            const QPointF correctedPos = placement.pos() + info->halfSize;
+            serializer.addRecord(info->nameIndex, placement.tileIndex,
+                                 static_cast<int>(correctedPos.x()), static_cast<int>(correctedPos.y()),
+                                 placement.id);
+        }
+    }
+}
+
+void SceneModel::restartJournal(const QString &baseScenePath)
+{
+    if (!m_journalEnabled) {
+        return;
+    }
+
+    // Tudo até aqui está na cena de base (ou a cena está vazia): o journal recomeça do zero
+    if (!m_journal.start(EditJournal::journalPathFor(baseScenePath), baseScenePath, m_projectPath)) {
+        qWarning() << "Edições não serão registradas no journal";
+    }
+}
+
+int SceneModel::replayJournal(const EditJournal::Contents &contents, int *skipped)
+{
+    QVector<ResolvedEntity> resolvedEntities(contents.entityNames.size());
+    for (int i = 0; i < contents.entityNames.size(); ++i) {
+        resolvedEntities[i] = resolveEntity(m_entityManager, contents.entityNames.at(i));
+    }
+
+    // Aplicado em massa: grade e view atualizadas uma vez no fim
+    QVector<Action> applied;
+    applied.reserve(contents.entries.size());
+    int skippedCount = 0;
+    m_placements.suspendIndexing();
+    for (const EditJournal::Entry &entry : contents.entries) {
+        const ResolvedEntity *resolved = entry.nameIndex < static_cast<quint32>(resolvedEntities.size())
+                                             ? &resolvedEntities.at(static_cast<int>(entry.nameIndex)) : nullptr;
+        if (!resolved || !resolved->entity) {
+            ++skippedCount;
+            continue;
+        }
+
+        Action action;
+        action.type = entry.type;
+        action.entity = resolved->entity;
+        action.tileIndex = entry.tileIndex;
+        action.oldPos = entry.oldPos;
+        action.newPos = entry.newPos;
+        action.placementId = entry.placementId;
+        action.sequence = PlacementStore::NextSequence;
+
+        bool ok = false;
+        if (entry.type == Action::ADD) {
+            ok = m_placements.add(resolved->entity, entry.tileIndex, entry.newPos, resolved->size, entry.placementId)
+                 != PlacementStore::InvalidHandle;
+            if (ok) {
+                resolved->entity->addPlacementRef();
+            }
+        } else {
+            const int handle = m_placements.handleForId(entry.placementId);
+            ok = handle != PlacementStore::InvalidHandle;
+            if (ok && entry.type == Action::REMOVE) {
+                m_placements.at(handle).entity->releasePlacementRef();
+                m_placements.remove(handle);
+            } else if (ok) {
+                m_placements.move(handle, entry.newPos);
+            }
+        }
+
+        if (ok) {
+            applied.append(action);
+        } else {
+            ++skippedCount;
+        }
+    }
+    m_placements.resumeIndexing();
+    if (!applied.isEmpty()) {
+        m_modified = true;
+    }
+    emit placementsChanged(QRectF());
+
+    // O journal atual já começa com o que foi recuperado, caso o editor caia de novo antes do save
+    m_journal.beginStep();
+    for (const Action &action : applied) {
+        m_journal.record(action);
+    }
+    m_journal.endStep();
+    m_journal.flush();
+
+    if (skipped) {
+        *skipped = skippedCount;
+    }
+    return applied.size();
+}
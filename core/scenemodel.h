@@ -0,0 +1,133 @@
+#ifndef SCENEMODEL_H
+#define SCENEMODEL_H
+
+#include <QObject>
+#include <QPointF>
+#include <QRectF>
+#include <QSizeF>
+#include <QString>
+#include <QVector>
+#include "placementstore.h"
+#include "undohistory.h"
+#include "editjournal.h"
+#include "incrementalscenesaver.h"
+
+class Entity;
+class EntityManager;
+class SceneSerializer;
+
+// Modelo da cena, sem QtWidgets: é o que o editor mostra e o que ferramentas e benchmarks usam.
+//
+// Dono das colocações, do histórico de undo/redo, do journal de edições e do save incremental.
+// Toda edição passa por aqui: aplica na PlacementStore, grava a ação no histórico e no journal
+// (quando record é true) e avisa a view por placementsChanged(). As regras do pincel e da
+// borracha (tamanho da colocação, encaixe na grade, alvo da borracha) também ficam aqui.
+class SceneModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef UndoAction Action;
+
+    struct FileStats
+    {
+        int entityCount;        // Colocações lidas ou registros formatados
+        int missingCount;       // Registros com entidade não encontrada (importação)
+        int sectionCount;       // Chunks de gravação (save .esc)
+        int reusedSections;     // Chunks copiados do arquivo anterior (save .esc)
+        bool skipped;           // Save sem nenhuma alteração
+        qint64 elapsedMs;
+    };
+
+    // Fração da borracha que precisa cobrir a colocação para apagá-la
+    static constexpr qreal EraseOverlapThreshold = 0.25;
+
+    explicit SceneModel(EntityManager *entityManager, QObject *parent = nullptr);
+
+    EntityManager *entityManager() const { return m_entityManager; }
+    PlacementStore &placements() { return m_placements; }
+    const PlacementStore &placements() const { return m_placements; }
+    UndoHistory &history() { return m_history; }
+    const UndoHistory &history() const { return m_history; }
+    EditJournal &journal() { return m_journal; }
+
+    QString scenePath() const { return m_scenePath; }
+    void setScenePath(const QString &path) { m_scenePath = path; }
+    QString projectPath() const { return m_projectPath; }
+    void setProjectPath(const QString &path) { m_projectPath = path; }
+    // Alguma colocação mudou desde o último save, importação ou clear()
+    bool isModified() const { return m_modified; }
+
+    // Tamanho usado para colocar e gravar a entidade: atual, colisão ou 32x32
+    static QSizeF placementSize(const Entity *entity);
+    // Encaixe do pincel com Shift: múltiplo do tamanho da colocação mais próximo
+    static QPointF snapToEntityGrid(const QPointF &pos, const QSizeF &size);
+
+    int addPlacement(Entity *entity, int tileIndex, const QPointF &pos, bool record = true,
+                     quint64 placementId = PlacementStore::InvalidId,
+                     quint32 sequence = PlacementStore::NextSequence);
+    void removePlacement(int handle, bool record = true);
+    // Remove todas em um passo só do histórico
+    void removePlacements(const QVector<int> &handles);
+    void movePlacement(int handle, const QPointF &pos, bool record = true);
+    // Movimentos já feitos direto na store (arraste da camada): só grava, em um passo
+    void recordMoves(const QVector<int> &handles, const QVector<QPointF> &oldPositions);
+    // Colocação que a borracha apaga no retângulo: a de maior sobreposição acima do limite
+    int eraseTarget(const QRectF &eraseRect, qreal *overlapRatio = nullptr) const;
+
+    // Podem ser aninhados, como em UndoHistory
+    void beginStep();
+    void endStep();
+    bool undo();
+    bool redo();
+
+    // Remove tudo e esvazia o histórico
+    void clear();
+
+    // .esc ou .escb, pela extensão. importScene substitui a cena atual.
+    bool importScene(const QString &path, FileStats *stats = nullptr);
+    // Save incremental no .esc (sem nada sujo, não grava); .escb é sempre completo
+    bool saveScene(const QString &path, FileStats *stats = nullptr);
+    // .esc completo em qualquer caminho, sem mexer no estado de save
+    bool exportScene(const QString &path, FileStats *stats = nullptr);
+    void fillSerializer(SceneSerializer &serializer, bool skipCleanSections = false) const;
+    // Erro da última importação, save ou export (importação com XML quebrado devolve true e preenche)
+    QString errorString() const { return m_errorString; }
+
+    // Desligado, restartJournal não cria arquivo nem sessão (ferramentas e benchmarks)
+    void setJournalEnabled(bool enabled) { m_journalEnabled = enabled; }
+    bool isJournalEnabled() const { return m_journalEnabled; }
+    // O journal recomeça vazio sobre baseScenePath (vazio = cena sem arquivo)
+    void restartJournal(const QString &baseScenePath);
+    // Aplica as entradas em massa e as grava no journal atual; devolve quantas foram aplicadas
+    int replayJournal(const EditJournal::Contents &contents, int *skipped = nullptr);
+
+signals:
+    // Área alterada na cena; retângulo nulo = cena inteira
+    void placementsChanged(const QRectF &area);
+    // O handle deixou de existir (pode ser reaproveitado depois)
+    void placementRemoved(int handle);
+    void historyChanged();
+
+private:
+    void record(const Action &action);
+    bool applyStep(const QVector<Action> &actions, bool undo);
+    bool importEsc(const QString &path, FileStats &stats);
+    bool importEscb(const QString &path, FileStats &stats);
+    int addImported(Entity *entity, int tileIndex, const QPointF &pos, const QSizeF &size, quint64 placementId);
+    bool saveEsc(const QString &path, FileStats &stats);
+
+    EntityManager *m_entityManager;
+    PlacementStore m_placements;
+    UndoHistory m_history;
+    EditJournal m_journal;
+    // Faixas de bytes do último .esc gravado, para o próximo save reaproveitar
+    IncrementalSceneSaver m_sceneSaver;
+    QString m_scenePath;
+    QString m_projectPath;
+    QString m_errorString;
+    bool m_journalEnabled;
+    bool m_modified;
+};
+
+#endif // SCENEMODEL_H
@@ -0,0 +1,324 @@
+#include "sceneserializer.h"
+#include <QIODevice>
+#include <QXmlStreamReader>
+#include <QDebug>
+#include <QtConcurrent>
+#include <cmath>
+
+namespace {
+
+template <int N>
+inline void appendLiteral(QByteArray &out, const char (&text)[N])
+{
+    out.append(text, N - 1);
+}
+
+// Bytes fixos de um bloco <Entity> fora o nome e os números (com folga)
+const int EntityBlockOverhead = 200;
+
+// Functor usado pelo QtConcurrent: formata um pedaço de registros
+struct ChunkFormatter
+{
+    typedef QByteArray result_type;
+
+    const SceneSerializer *serializer;
+    int chunkSize;
+
+    QByteArray operator()(int chunk) const
+    {
+        const int first = chunk * chunkSize;
+        const int count = qMin(chunkSize, serializer->recordCount() - first);
+        return serializer->formatRange(first, count);
+    }
+};
+
+}
+
+SceneSerializer::SceneSerializer()
+    : m_chunkSize(DefaultChunkSize),
+      m_parallel(true)
+{
+}
+
+quint32 SceneSerializer::internName(const QString &entityName)
+{
+    auto it = m_nameIndex.constFind(entityName);
+    if (it != m_nameIndex.constEnd()) {
+        return it.value();
+    }
+    const quint32 index = static_cast<quint32>(m_names.size());
+    m_names.append(entityName);
+    m_escapedFileNames.append(escapeText(entityName + ".ent"));
+    m_nameIndex.insert(entityName, index);
+    return index;
+}
+
+void SceneSerializer::addRecord(quint32 nameIndex, int spriteFrame, float x, float y, quint64 id,
+                                float z, float angle)
+{
+    Record record;
+    record.id = id != 0 ? id : static_cast<quint64>(m_records.size()) + 1;
+    record.nameIndex = nameIndex;
+    record.spriteFrame = spriteFrame;
+    record.x = x;
+    record.y = y;
+    record.z = z;
+    record.angle = angle;
+    m_records.append(record);
+    if (!m_sections.isEmpty()) {
+        ++m_sections.last().recordCount;
+    }
+}
+
+void SceneSerializer::clear()
+{
+    m_records.clear();
+    m_sections.clear();
+    m_names.clear();
+    m_escapedFileNames.clear();
+    m_nameIndex.clear();
+}
+
+void SceneSerializer::beginSection(quint64 key, bool dirty)
+{
+    Section section;
+    section.key = key;
+    section.firstRecord = m_records.size();
+    section.recordCount = 0;
+    section.dirty = dirty;
+    m_sections.append(section);
+}
+
+void SceneSerializer::setChunkSize(int recordsPerChunk)
+{
+    m_chunkSize = qMax(1, recordsPerChunk);
+}
+
+QByteArray SceneSerializer::toEsc() const
+{
+    const bool hasEntities = !m_records.isEmpty();
+    const int chunkCount = (m_records.size() + m_chunkSize - 1) / m_chunkSize;
+
+    QVector<QByteArray> chunks;
+    if (m_parallel && chunkCount > 1) {
+        QVector<int> chunkIndexes(chunkCount);
+        for (int i = 0; i < chunkCount; ++i) {
+            chunkIndexes[i] = i;
+        }
+        chunks = QtConcurrent::blockingMapped(chunkIndexes, ChunkFormatter{this, m_chunkSize});
+    } else {
+        ChunkFormatter formatter{this, m_chunkSize};
+        chunks.reserve(chunkCount);
+        for (int i = 0; i < chunkCount; ++i) {
+            chunks.append(formatter(i));
+        }
+    }
+
+    const QByteArray header = escHeader(hasEntities);
+    const QByteArray footer = escFooter(hasEntities);
+    int totalSize = header.size() + footer.size();
+    for (const QByteArray &chunk : chunks) {
+        totalSize += chunk.size();
+    }
+
+    QByteArray document;
+    document.reserve(totalSize);
+    document.append(header);
+    for (const QByteArray &chunk : chunks) {
+        document.append(chunk);
+    }
+    document.append(footer);
+    return document;
+}
+
+bool SceneSerializer::writeEsc(QIODevice *device) const
+{
+    const QByteArray document = toEsc();
+    return device->write(document) == document.size();
+}
+
+bool SceneSerializer::readEsc(QIODevice *device)
+{
+    clear();
+
+    QXmlStreamReader xml(device);
+    int depth = 0;
+    int entityDepth = -1;
+    QString name;
+    quint64 id = 0;
+    int spriteFrame = 0;
+    float x = 0;
+    float y = 0;
+    float z = 0;
+    float angle = 0;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            ++depth;
+            if (entityDepth < 0 && xml.name() == QLatin1String("Entity")) {
+                entityDepth = depth;
+                id = xml.attributes().value("id").toULongLong();
+                spriteFrame = xml.attributes().value("spriteFrame").toInt();
+                name.clear();
+                x = 0;
+                y = 0;
+                z = 0;
+                angle = 0;
+            } else if (entityDepth >= 0 && depth == entityDepth + 1) {
+                if (xml.name() == QLatin1String("EntityName")) {
+                    name = xml.readElementText();
+                    name.replace(QLatin1String(".ent"), QString());
+                    // readElementText já consumiu o fim do elemento
+                    --depth;
+                } else if (xml.name() == QLatin1String("Position")) {
+                    const QXmlStreamAttributes attributes = xml.attributes();
+                    x = attributes.value("x").toFloat();
+                    y = attributes.value("y").toFloat();
+                    z = attributes.value("z").toFloat();
+                    angle = attributes.value("angle").toFloat();
+                }
+            }
+        } else if (xml.isEndElement()) {
+            if (depth == entityDepth) {
+                addRecord(internName(name), spriteFrame, x, y, id, z, angle);
+                entityDepth = -1;
+            }
+            --depth;
+        }
+    }
+
+    if (xml.hasError()) {
+        qWarning() << "Erro ao ler a cena:" << xml.errorString() << "na linha" << xml.lineNumber();
+        clear();
+        return false;
+    }
+    return true;
+}
+
+QByteArray SceneSerializer::escHeader(bool hasEntities)
+{
+    QByteArray header;
+    appendLiteral(header, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                          "<Ethanon>\n"
+                          "    <SceneProperties lightIntensity=\"2\" parallaxIntensity=\"0\">\n"
+                          "        <Ambient r=\"1\" g=\"1\" b=\"1\"/>\n"
+                          "        <ZAxisDirection x=\"0\" y=\"-1\"/>\n"
+                          "    </SceneProperties>\n");
+    // Sem filhos, o QXmlStreamWriter fecha o elemento vazio na mesma tag
+    if (hasEntities) {
+        appendLiteral(header, "    <EntitiesInScene>");
+    } else {
+        appendLiteral(header, "    <EntitiesInScene/>");
+    }
+    return header;
+}
+
+QByteArray SceneSerializer::escFooter(bool hasEntities)
+{
+    QByteArray footer;
+    if (hasEntities) {
+        appendLiteral(footer, "\n    </EntitiesInScene>");
+    }
+    appendLiteral(footer, "\n</Ethanon>\n");
+    return footer;
+}
+
+void SceneSerializer::appendEntityBlock(QByteArray &out, const Record &record) const
+{
+    const QByteArray &fileName = m_escapedFileNames.at(static_cast<int>(record.nameIndex));
+
+    appendLiteral(out, "\n        <Entity id=\"");
+    appendInt(out, static_cast<qint64>(record.id));
+    appendLiteral(out, "\" spriteFrame=\"");
+    appendInt(out, record.spriteFrame);
+    appendLiteral(out, "\">\n            <EntityName>");
+    out.append(fileName);
+    appendLiteral(out, "</EntityName>\n            <Position x=\"");
+    appendNumber(out, record.x);
+    appendLiteral(out, "\" y=\"");
+    appendNumber(out, record.y);
+    appendLiteral(out, "\" z=\"");
+    appendNumber(out, record.z);
+    appendLiteral(out, "\" angle=\"");
+    appendNumber(out, record.angle);
+    appendLiteral(out, "\"/>\n            <Entity>\n                <FileName>");
+    out.append(fileName);
+    appendLiteral(out, "</FileName>\n            </Entity>\n        </Entity>");
+}
+
+QByteArray SceneSerializer::formatRange(int first, int count) const
+{
+    int estimate = 0;
+    for (int i = first; i < first + count; ++i) {
+        estimate += EntityBlockOverhead + 2 * m_escapedFileNames.at(static_cast<int>(m_records[i].nameIndex)).size();
+    }
+
+    QByteArray out;
+    out.reserve(estimate);
+    for (int i = 0; i < count; ++i) {
+        appendEntityBlock(out, m_records[first + i]);
+    }
+    return out;
+}
+
+QByteArray SceneSerializer::escapeText(const QString &text)
+{
+    // Mesmo escape do QXmlStreamWriter::writeCharacters
+    QString escaped;
+    escaped.reserve(text.size());
+    for (const QChar c : text) {
+        switch (c.unicode()) {
+        case '<':
+            escaped += QLatin1String("&lt;");
+            break;
+        case '>':
+            escaped += QLatin1String("&gt;");
+            break;
+        case '&':
+            escaped += QLatin1String("&amp;");
+            break;
+        case '"':
+            escaped += QLatin1String("&quot;");
+            break;
+        default:
+            escaped += c;
+            break;
+        }
+    }
+    return escaped.toUtf8();
+}
+
+void SceneSerializer::appendInt(QByteArray &out, qint64 value)
+{
+    char buffer[24];
+    char *end = buffer + sizeof(buffer);
+    char *p = end;
+    quint64 magnitude = value < 0 ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        *--p = '-';
+    }
+    out.append(p, static_cast<int>(end - p));
+}
+
+void SceneSerializer::appendNumber(QByteArray &out, float value)
+{
+    // O caminho comum (posições do editor, z e ângulo zerados) sai igual ao appendInt
+    if (value == std::trunc(value) && std::fabs(value) < 2147483648.0f) {
+        appendInt(out, static_cast<qint64>(value));
+        return;
+    }
+    // 9 dígitos sempre bastam para um float; tenta antes os mais curtos
+    QByteArray text;
+    for (int precision = 1; precision <= 9; ++precision) {
+        text = QByteArray::number(static_cast<double>(value), 'g', precision);
+        if (text.toFloat() == value) {
+            break;
+        }
+    }
+    out.append(text);
+}
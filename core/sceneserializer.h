@@ -0,0 +1,99 @@
+#ifndef SCENESERIALIZER_H
+#define SCENESERIALIZER_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+
+class QIODevice;
+
+// Escritor do formato .esc usado por saveScene e exportScene.
+//
+// Recebe um registro por entidade (id, nome internado, spriteFrame, centro, z e ângulo, na
+// ordem em que devem sair) e gera exatamente os bytes que o QXmlStreamWriter com
+// autoformatação gerava antes para as posições inteiras do editor. Valores fracionários saem
+// com o menor número de dígitos que relido dá o mesmo float, então cenas feitas no Ethanon
+// passam por .esc -> .escb -> .esc sem perder profundidade, rotação nem subpixel. Os blocos <Entity> são formatados em pedaços paralelos,
+// direto em QByteArray, e concatenados na ordem.
+class SceneSerializer
+{
+public:
+    struct Record
+    {
+        quint64 id;         // Atributo id do <Entity>
+        quint32 nameIndex;
+        qint32 spriteFrame;
+        float x;            // Centro
+        float y;
+        float z;
+        float angle;
+    };
+
+    // Faixa de registros de um chunk de gravação (ver IncrementalSceneSaver). Um chunk limpo
+    // não traz registros: os bytes dele vêm do arquivo anterior.
+    struct Section
+    {
+        quint64 key;
+        int firstRecord;
+        int recordCount;
+        bool dirty;
+    };
+
+    static constexpr int DefaultChunkSize = 4096;
+
+    SceneSerializer();
+
+    // Índice do nome (sem ".ent") na tabela; o mesmo nome devolve o mesmo índice
+    quint32 internName(const QString &entityName);
+    QString entityName(quint32 nameIndex) const { return m_names.value(static_cast<int>(nameIndex)); }
+    int nameCount() const { return m_names.size(); }
+
+    void reserve(int recordCount) { m_records.reserve(recordCount); }
+    // id 0 usa a posição do registro (recordCount() + 1), como o editor fazia antes
+    void addRecord(quint32 nameIndex, int spriteFrame, float x, float y, quint64 id = 0,
+                   float z = 0, float angle = 0);
+    const QVector<Record> &records() const { return m_records; }
+    int recordCount() const { return m_records.size(); }
+    void clear();
+
+    // Os registros adicionados depois pertencem a esta seção
+    void beginSection(quint64 key, bool dirty);
+    const QVector<Section> &sections() const { return m_sections; }
+
+    void setChunkSize(int recordsPerChunk);
+    int chunkSize() const { return m_chunkSize; }
+    void setParallel(bool parallel) { m_parallel = parallel; }
+    bool isParallel() const { return m_parallel; }
+
+    // Documento .esc completo
+    QByteArray toEsc() const;
+    bool writeEsc(QIODevice *device) const;
+    // Lê um .esc para a tabela de nomes e registros (substitui o conteúdo atual)
+    bool readEsc(QIODevice *device);
+
+    // Partes do documento, para quem monta o arquivo aos pedaços
+    static QByteArray escHeader(bool hasEntities);
+    static QByteArray escFooter(bool hasEntities);
+    // Bloco <Entity> de um registro
+    void appendEntityBlock(QByteArray &out, const Record &record) const;
+    // Blocos dos registros [first, first + count)
+    QByteArray formatRange(int first, int count) const;
+
+    static QByteArray escapeText(const QString &text);
+    static void appendInt(QByteArray &out, qint64 value);
+    // Inteiro quando o valor é inteiro; senão a forma mais curta que relê o mesmo float
+    static void appendNumber(QByteArray &out, float value);
+
+private:
+    QVector<Record> m_records;
+    QVector<Section> m_sections;
+    QVector<QString> m_names;
+    // "nome.ent" já escapado para texto XML, uma vez por nome
+    QVector<QByteArray> m_escapedFileNames;
+    QHash<QString, quint32> m_nameIndex;
+    int m_chunkSize;
+    bool m_parallel;
+};
+
+#endif // SCENESERIALIZER_H
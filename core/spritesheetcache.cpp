@@ -0,0 +1,93 @@
+#include "spritesheetcache.h"
+#include "entity.h"
+#include "asynclogger.h"
+#include <QDebug>
+
+SpritesheetCache::SpritesheetCache(qint64 budgetBytes)
+    : m_budgetBytes(budgetBytes),
+      m_decodedBytes(0),
+      m_evictionCount(0)
+{
+}
+
+SpritesheetCache::~SpritesheetCache()
+{
+    // As entidades normalmente já se removeram; descarregar o que sobrou
+    for (const Entry &entry : m_lru) {
+        entry.entity->releaseDecodedImage();
+    }
+}
+
+void SpritesheetCache::setBudgetBytes(qint64 budgetBytes)
+{
+    m_budgetBytes = budgetBytes;
+    trim();
+}
+
+void SpritesheetCache::insert(const Entity *entity, qint64 bytes)
+{
+    auto it = m_index.find(entity);
+    if (it != m_index.end()) {
+        m_decodedBytes += bytes - it.value()->bytes;
+        it.value()->bytes = bytes;
+        m_lru.splice(m_lru.begin(), m_lru, it.value());
+    } else {
+        m_lru.push_front({ entity, bytes });
+        m_index.insert(entity, m_lru.begin());
+        m_decodedBytes += bytes;
+    }
+    trim();
+}
+
+void SpritesheetCache::touch(const Entity *entity)
+{
+    auto it = m_index.find(entity);
+    if (it != m_index.end() && it.value() != m_lru.begin()) {
+        m_lru.splice(m_lru.begin(), m_lru, it.value());
+    }
+}
+
+void SpritesheetCache::remove(const Entity *entity)
+{
+    auto it = m_index.find(entity);
+    if (it == m_index.end()) {
+        return;
+    }
+    m_decodedBytes -= it.value()->bytes;
+    m_lru.erase(it.value());
+    m_index.erase(it);
+}
+
+QVector<QPair<const Entity*, qint64>> SpritesheetCache::decodedEntries() const
+{
+    QVector<QPair<const Entity*, qint64>> entries;
+    entries.reserve(static_cast<int>(m_lru.size()));
+    for (const Entry &entry : m_lru) {
+        entries.append(qMakePair(entry.entity, entry.bytes));
+    }
+    return entries;
+}
+
+void SpritesheetCache::trim()
+{
+    if (m_decodedBytes <= m_budgetBytes || m_lru.size() < 2) {
+        return;
+    }
+
+    auto it = std::prev(m_lru.end());
+    while (m_decodedBytes > m_budgetBytes && it != m_lru.begin()) {
+        auto current = it--;
+        const Entity *entity = current->entity;
+        if (entity->placementRefCount() > 0) {
+            continue;
+        }
+
+        SCENE_LOG_DEBUG("SpritesheetCache") << "Descarregando spritesheet de" << entity->getName()
+                                            << "-" << current->bytes << "bytes";
+        m_decodedBytes -= current->bytes;
+        m_index.remove(entity);
+        m_lru.erase(current);
+        ++m_evictionCount;
+        entity->releaseDecodedImage();
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef SPRITESHEETCACHE_H
+#define SPRITESHEETCACHE_H
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <list>
+
+class Entity;
+
+// LRU dos spritesheets decodificados das entidades.
+//
+// Entity só decodifica a imagem na primeira vez que o pixmap é pedido e se registra aqui.
+// Quando o total decodificado passa do orçamento, as entidades usadas há mais tempo e
+// sem nenhuma colocação viva na cena descarregam o pixmap (que volta a ser decodificado
+// se for pedido de novo). Usado apenas na thread da GUI.
+class SpritesheetCache
+{
+public:
+    static constexpr qint64 DefaultBudgetBytes = 256LL * 1024 * 1024;
+
+    explicit SpritesheetCache(qint64 budgetBytes = DefaultBudgetBytes);
+    ~SpritesheetCache();
+
+    void setBudgetBytes(qint64 budgetBytes);
+    qint64 budgetBytes() const { return m_budgetBytes; }
+
+    // Total de bytes de imagem decodificada mantidos pelas entidades registradas
+    qint64 decodedBytes() const { return m_decodedBytes; }
+    int decodedCount() const { return static_cast<int>(m_lru.size()); }
+    int evictionCount() const { return m_evictionCount; }
+    // Bytes decodificados por entidade, da usada mais recentemente para a menos
+    QVector<QPair<const Entity*, qint64>> decodedEntries() const;
+
+    void insert(const Entity *entity, qint64 bytes);
+    void touch(const Entity *entity);
+    void remove(const Entity *entity);
+
+    // Descarrega entidades sem colocações, da menos recente para a mais recente,
+    // até caber no orçamento. A entrada mais recente nunca é descarregada.
+    void trim();
+
+private:
+    struct Entry {
+        const Entity *entity;
+        qint64 bytes;
+    };
+
+    std::list<Entry> m_lru;  // frente = usada mais recentemente
+    QHash<const Entity*, std::list<Entry>::iterator> m_index;
+    qint64 m_budgetBytes;
+    qint64 m_decodedBytes;
+    int m_evictionCount;
+};
+
+#endif // SPRITESHEETCACHE_H
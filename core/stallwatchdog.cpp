@@ -0,0 +1,274 @@
+#include "stallwatchdog.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+const char noOperation[] = "(nenhuma operação instrumentada)";
+
+}
+
+std::atomic<bool> StallWatchdog::s_running(false);
+
+StallWatchdog &StallWatchdog::instance()
+{
+    static StallWatchdog watchdog;
+    return watchdog;
+}
+
+StallWatchdog::StallWatchdog()
+    : m_thresholdMs(DefaultThresholdMs),
+      m_guiThread(nullptr),
+      m_thread(nullptr),
+      m_stopRequested(false),
+      m_answeredPing(0),
+      m_answeredAtNsecs(0)
+{
+    m_clock.start();
+
+    bool ok = false;
+    const int envThreshold = qEnvironmentVariableIntValue("SCENE_STALL_MS", &ok);
+    if (ok && envThreshold > 0) {
+        m_thresholdMs = envThreshold;
+    }
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+void StallWatchdog::setThresholdMs(int thresholdMs)
+{
+    // Vale a partir do próximo start()
+    m_thresholdMs = qMax(1, thresholdMs);
+}
+
+void StallWatchdog::start()
+{
+    if (m_thread) {
+        return;
+    }
+    if (!QCoreApplication::instance()) {
+        qWarning() << "StallWatchdog: sem QCoreApplication para vigiar";
+        return;
+    }
+
+    m_guiThread = QThread::currentThread();
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    s_running.store(true, std::memory_order_relaxed);
+    m_thread = QThread::create([this]() { watchLoop(); });
+    m_thread->setObjectName("StallWatchdog");
+    m_thread->start(QThread::HighPriority);
+    qInfo() << "Vigia da interface ligado, limite de" << m_thresholdMs << "ms";
+}
+
+void StallWatchdog::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+    s_running.store(false, std::memory_order_relaxed);
+    m_stopRequested.store(true, std::memory_order_relaxed);
+    m_wakeMutex.lock();
+    m_wake.wakeOne();
+    m_wakeMutex.unlock();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    qInfo().noquote() << summary();
+}
+
+int StallWatchdog::enterOperation(const char *name)
+{
+    if (QThread::currentThread() != m_guiThread) {
+        return -1;
+    }
+    QMutexLocker locker(&m_operationsMutex);
+    m_operations.append(Operation { name, QString() });
+    return m_operations.size() - 1;
+}
+
+void StallWatchdog::setOperationArg(int depth, const char *key, const QString &value)
+{
+    if (depth < 0) {
+        return;
+    }
+    QMutexLocker locker(&m_operationsMutex);
+    if (depth < m_operations.size()) {
+        QString &args = m_operations[depth].args;
+        if (!args.isEmpty()) {
+            args += QLatin1String(", ");
+        }
+        args += QLatin1String(key) + QLatin1Char('=') + value;
+    }
+}
+
+void StallWatchdog::leaveOperation(int depth)
+{
+    if (depth < 0) {
+        return;
+    }
+    QMutexLocker locker(&m_operationsMutex);
+    if (depth < m_operations.size()) {
+        m_operations.resize(depth);
+    }
+}
+
+void StallWatchdog::snapshotOperations(QString *operation, QString *args) const
+{
+    QMutexLocker locker(&m_operationsMutex);
+    QStringList names;
+    for (const Operation &entry : m_operations) {
+        names << QLatin1String(entry.name);
+    }
+    *operation = names.join(QLatin1String(" > "));
+    *args = m_operations.isEmpty() ? QString() : m_operations.last().args;
+}
+
+// Um ping por vez: enquanto o anterior não volta, só se mede há quanto tempo ele espera
+void StallWatchdog::watchLoop()
+{
+    const int checkIntervalMs = qMax(10, m_thresholdMs / 4);
+    const qint64 thresholdNsecs = qint64(m_thresholdMs) * 1000000;
+    quint64 ping = m_answeredPing.load(std::memory_order_acquire);
+    qint64 sentAtNsecs = 0;
+    bool waiting = false;
+    bool stalled = false;
+    QString operation;
+    QString args;
+
+    while (!m_stopRequested.load(std::memory_order_relaxed)) {
+        if (waiting && m_answeredPing.load(std::memory_order_acquire) == ping) {
+            waiting = false;
+            if (stalled) {
+                stalled = false;
+                const qint64 durationMs = (m_answeredAtNsecs.load(std::memory_order_relaxed) - sentAtNsecs) / 1000000;
+                const QString where = operation.isEmpty() ? QString(noOperation) : operation;
+                qWarning().noquote() << QString("Interface travada por %1 ms em %2%3")
+                                            .arg(durationMs).arg(where)
+                                            .arg(args.isEmpty() ? QString() : " (" + args + ")");
+                recordStall(where, args, durationMs);
+            }
+        }
+
+        const qint64 now = m_clock.nsecsElapsed();
+        if (!waiting) {
+            ++ping;
+            sentAtNsecs = now;
+            waiting = true;
+            operation.clear();
+            args.clear();
+            const quint64 id = ping;
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [this, id]() {
+                m_answeredAtNsecs.store(m_clock.nsecsElapsed(), std::memory_order_relaxed);
+                m_answeredPing.store(id, std::memory_order_release);
+            }, Qt::QueuedConnection);
+        } else if (now - sentAtNsecs > thresholdNsecs) {
+            // A primeira operação vista durante a travada fica com a culpa
+            if (operation.isEmpty()) {
+                snapshotOperations(&operation, &args);
+            }
+            if (!stalled) {
+                stalled = true;
+                qWarning().noquote() << QString("Interface sem responder há %1 ms em %2")
+                                            .arg((now - sentAtNsecs) / 1000000)
+                                            .arg(operation.isEmpty() ? QString(noOperation) : operation);
+            }
+        }
+
+        m_wakeMutex.lock();
+        if (!m_stopRequested.load(std::memory_order_relaxed)) {
+            m_wake.wait(&m_wakeMutex, checkIntervalMs);
+        }
+        m_wakeMutex.unlock();
+    }
+
+    // Saindo no meio de uma travada: conta o que passou até aqui
+    if (stalled) {
+        recordStall(operation.isEmpty() ? QString(noOperation) : operation, args,
+                    (m_clock.nsecsElapsed() - sentAtNsecs) / 1000000);
+    }
+}
+
+void StallWatchdog::recordStall(const QString &operation, const QString &args, qint64 durationMs)
+{
+    QMutexLocker locker(&m_statsMutex);
+    StallStats &stats = m_stats[operation];
+    ++stats.count;
+    stats.totalMs += durationMs;
+    if (durationMs > stats.maxMs) {
+        stats.maxMs = durationMs;
+        stats.worstArgs = args;
+    }
+}
+
+int StallWatchdog::stallCount() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    int count = 0;
+    for (const StallStats &stats : m_stats) {
+        count += stats.count;
+    }
+    return count;
+}
+
+QString StallWatchdog::summary() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    QStringList operations = m_stats.keys();
+    std::sort(operations.begin(), operations.end(), [this](const QString &a, const QString &b) {
+        return m_stats.value(a).totalMs > m_stats.value(b).totalMs;
+    });
+
+    int count = 0;
+    for (const StallStats &stats : m_stats) {
+        count += stats.count;
+    }
+    QStringList lines;
+    lines << QString("Travadas da interface acima de %1 ms: %2").arg(m_thresholdMs).arg(count);
+    for (const QString &operation : operations) {
+        const StallStats stats = m_stats.value(operation);
+        lines << QString("  %1: %2 travadas, %3 ms no total, pior %4 ms%5")
+                     .arg(operation).arg(stats.count).arg(stats.totalMs).arg(stats.maxMs)
+                     .arg(stats.worstArgs.isEmpty() ? QString() : " (" + stats.worstArgs + ")");
+    }
+    return lines.join('\n');
+}
+
+QJsonObject StallWatchdog::toJson() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    QJsonArray operations;
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        QJsonObject entry;
+        entry.insert("operation", it.key());
+        entry.insert("count", it.value().count);
+        entry.insert("total_ms", it.value().totalMs);
+        entry.insert("max_ms", it.value().maxMs);
+        entry.insert("worst_args", it.value().worstArgs);
+        operations.append(entry);
+    }
+    QJsonObject root;
+    root.insert("threshold_ms", m_thresholdMs);
+    root.insert("stalls", operations);
+    return root;
+}
+
+bool StallWatchdog::writeJson(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar as travadas da interface:" << path;
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    return file.commit();
+}
@@ -0,0 +1,99 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+
+class QThread;
+
+// Vigia do laço de eventos da thread da interface.
+//
+// Uma thread própria posta um ping na fila da thread da interface a cada CheckIntervalMs e
+// espera a resposta; passando de thresholdMs sem resposta, a interface está travada. A
+// operação culpada vem dos TraceSpan abertos na thread da interface, que também se
+// registram aqui enquanto o vigia está rodando (nome e argumentos, do mais externo ao mais
+// interno). Cada travada vai para o log ao ser detectada e de novo ao acabar, com a duração;
+// stop() loga o resumo por operação, da que mais somou tempo travada para a que menos.
+//
+// O limite padrão pode ser trocado por SCENE_STALL_MS no ambiente. Parado, os spans pagam
+// um load atômico; rodando, um lock sem disputa ao entrar e sair.
+class StallWatchdog
+{
+public:
+    static constexpr int DefaultThresholdMs = 200;
+
+    static StallWatchdog &instance();
+
+    ~StallWatchdog();
+
+    // Chamado na thread da interface, que passa a ser a vigiada
+    void start();
+    // Loga o resumo das travadas e encerra a thread do vigia
+    void stop();
+    static bool isRunning() { return s_running.load(std::memory_order_relaxed); }
+
+    int thresholdMs() const { return m_thresholdMs; }
+    void setThresholdMs(int thresholdMs);
+
+    // Pilha de operações da thread da interface; fora dela enterOperation() devolve -1
+    int enterOperation(const char *name);
+    void setOperationArg(int depth, const char *key, const QString &value);
+    void leaveOperation(int depth);
+
+    int stallCount() const;
+    QString summary() const;
+    QJsonObject toJson() const;
+    bool writeJson(const QString &path) const;
+
+private:
+    struct Operation
+    {
+        const char *name;
+        QString args;
+    };
+
+    struct StallStats
+    {
+        int count = 0;
+        qint64 totalMs = 0;
+        qint64 maxMs = 0;
+        QString worstArgs;
+    };
+
+    StallWatchdog();
+    StallWatchdog(const StallWatchdog &) = delete;
+    StallWatchdog &operator=(const StallWatchdog &) = delete;
+
+    void watchLoop();
+    // Operações abertas agora, "A > B", e os argumentos da mais interna
+    void snapshotOperations(QString *operation, QString *args) const;
+    void recordStall(const QString &operation, const QString &args, qint64 durationMs);
+
+    static std::atomic<bool> s_running;
+
+    int m_thresholdMs;
+    QElapsedTimer m_clock;
+    QThread *m_guiThread;
+    QThread *m_thread;
+    std::atomic<bool> m_stopRequested;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wake;
+
+    // Último ping respondido pela thread da interface e quando
+    std::atomic<quint64> m_answeredPing;
+    std::atomic<qint64> m_answeredAtNsecs;
+
+    mutable QMutex m_operationsMutex;
+    QVector<Operation> m_operations;
+
+    mutable QMutex m_statsMutex;
+    QMap<QString, StallStats> m_stats;
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,127 @@
+#include "tracerecorder.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QThread>
+
+namespace {
+
+// Ids pequenos e estáveis por thread; o Perfetto mostra uma linha por tid
+thread_local int currentThreadTraceId = -1;
+
+}
+
+std::atomic<bool> TraceRecorder::s_enabled(false);
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : m_dropped(0)
+{
+    m_clock.start();
+}
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    if (enabled == isEnabled()) {
+        return;
+    }
+    if (enabled) {
+        clear();
+        QMutexLocker locker(&m_mutex);
+        m_clock.restart();
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int TraceRecorder::eventCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_events.size();
+}
+
+int TraceRecorder::droppedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+void TraceRecorder::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_events.clear();
+    m_dropped = 0;
+}
+
+void TraceRecorder::addComplete(const char *name, const char *category, qint64 start, qint64 duration,
+                                const QJsonObject &args)
+{
+    QMutexLocker locker(&m_mutex);
+    if (currentThreadTraceId < 0) {
+        currentThreadTraceId = m_threadNames.size();
+        QThread *thread = QThread::currentThread();
+        QString threadName = thread->objectName();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            threadName = "Interface";
+        } else if (threadName.isEmpty()) {
+            threadName = QString("Thread %1").arg(currentThreadTraceId);
+        }
+        m_threadNames.append(threadName);
+    }
+
+    if (m_events.size() >= MaxEvents) {
+        ++m_dropped;
+        return;
+    }
+    m_events.append({ name, category, start, duration, currentThreadTraceId, args });
+}
+
+bool TraceRecorder::writeJson(const QString &path) const
+{
+    QJsonArray traceEvents;
+    {
+        QMutexLocker locker(&m_mutex);
+        const qint64 pid = QCoreApplication::applicationPid();
+        for (int i = 0; i < m_threadNames.size(); ++i) {
+            QJsonObject metadata;
+            metadata.insert("name", "thread_name");
+            metadata.insert("ph", "M");
+            metadata.insert("pid", pid);
+            metadata.insert("tid", i);
+            metadata.insert("args", QJsonObject { { "name", m_threadNames.at(i) } });
+            traceEvents.append(metadata);
+        }
+        for (const Event &event : m_events) {
+            QJsonObject object;
+            object.insert("name", QLatin1String(event.name));
+            object.insert("cat", QLatin1String(event.category));
+            object.insert("ph", "X");
+            object.insert("ts", event.start);
+            object.insert("dur", event.duration);
+            object.insert("pid", pid);
+            object.insert("tid", event.threadId);
+            if (!event.args.isEmpty()) {
+                object.insert("args", event.args);
+            }
+            traceEvents.append(object);
+        }
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", traceEvents);
+    root.insert("displayTimeUnit", "ms");
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar o trace:" << path;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
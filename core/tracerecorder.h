@@ -0,0 +1,121 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include "stallwatchdog.h"
+
+// Gravador de spans no formato de trace do Chrome (abre no Perfetto ou em chrome://tracing).
+//
+// Desligado, um TraceSpan custa um load atômico no construtor e outro no destrutor. Ligado,
+// cada span guarda início, duração, thread e argumentos; os eventos ficam em memória até
+// writeJson(). Passando de MaxEvents os spans seguintes são só contados.
+//
+//   TraceSpan span("SceneModel::importScene", "io");
+//   span.addArg("path", path);
+class TraceRecorder
+{
+public:
+    static constexpr int MaxEvents = 1000000;
+
+    static TraceRecorder &instance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    // Ligar descarta a gravação anterior
+    void setEnabled(bool enabled);
+
+    int eventCount() const;
+    int droppedCount() const;
+    bool writeJson(const QString &path) const;
+    void clear();
+
+    // Microssegundos desde o início da gravação
+    qint64 timestamp() const { return m_clock.nsecsElapsed() / 1000; }
+    void addComplete(const char *name, const char *category, qint64 start, qint64 duration,
+                     const QJsonObject &args);
+
+private:
+    struct Event
+    {
+        const char *name;
+        const char *category;
+        qint64 start;
+        qint64 duration;
+        int threadId;
+        QJsonObject args;
+    };
+
+    TraceRecorder();
+
+    static std::atomic<bool> s_enabled;
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    QVector<Event> m_events;
+    QVector<QString> m_threadNames;     // Pelo id sequencial de cada thread
+    int m_dropped;
+};
+
+// Um span do início ao fim do escopo. Os argumentos só são guardados com a gravação ligada.
+// Com o StallWatchdog rodando, os spans da thread da interface também dizem a ele qual
+// operação está em andamento, para as travadas saírem com nome e argumentos.
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const char *category = "editor")
+        : m_name(name),
+          m_category(category),
+          m_start(TraceRecorder::isEnabled() ? TraceRecorder::instance().timestamp() : -1),
+          m_watchdogDepth(StallWatchdog::isRunning() ? StallWatchdog::instance().enterOperation(name) : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_start >= 0 && TraceRecorder::isEnabled()) {
+            TraceRecorder &recorder = TraceRecorder::instance();
+            recorder.addComplete(m_name, m_category, m_start, recorder.timestamp() - m_start, m_args);
+        }
+        if (m_watchdogDepth >= 0) {
+            StallWatchdog::instance().leaveOperation(m_watchdogDepth);
+        }
+    }
+
+    bool isActive() const { return m_start >= 0; }
+
+    void addArg(const char *key, const QString &value)
+    {
+        if (isActive()) {
+            m_args.insert(QLatin1String(key), value);
+        }
+        if (m_watchdogDepth >= 0) {
+            StallWatchdog::instance().setOperationArg(m_watchdogDepth, key, value);
+        }
+    }
+
+    void addArg(const char *key, qint64 value)
+    {
+        if (isActive()) {
+            m_args.insert(QLatin1String(key), value);
+        }
+        if (m_watchdogDepth >= 0) {
+            StallWatchdog::instance().setOperationArg(m_watchdogDepth, key, QString::number(value));
+        }
+    }
+
+private:
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    const char *m_name;
+    const char *m_category;
+    qint64 m_start;
+    int m_watchdogDepth;
+    QJsonObject m_args;
+};
+
+#endif // TRACERECORDER_H
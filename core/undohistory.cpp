@@ -0,0 +1,189 @@
+#include "undohistory.h"
+#include "placementstore.h"
+
+UndoHistory::UndoHistory()
+    : m_stepDepth(0),
+      m_stepBytes(0),
+      m_memoryLimitBytes(DefaultMemoryLimitBytes),
+      m_droppedSteps(0)
+{
+    static_assert(sizeof(Command) == 32, "Registro do histórico deve continuar com 32 bytes");
+}
+
+void UndoHistory::beginStep()
+{
+    ++m_stepDepth;
+}
+
+void UndoHistory::endStep()
+{
+    if (m_stepDepth == 0) {
+        return;
+    }
+    if (--m_stepDepth == 0) {
+        closeOpenStep();
+    }
+}
+
+void UndoHistory::record(const UndoAction &action)
+{
+    clearRedo();
+    m_openStep.append(encode(action));
+    if (m_stepDepth == 0) {
+        closeOpenStep();
+    }
+}
+
+bool UndoHistory::canUndo() const
+{
+    return !m_undoSteps.isEmpty() || !m_openStep.isEmpty();
+}
+
+bool UndoHistory::canRedo() const
+{
+    return !m_redoSteps.isEmpty();
+}
+
+QVector<UndoAction> UndoHistory::takeUndoStep()
+{
+    // Undo no meio de um traço desfaz o que já foi gravado dele
+    closeOpenStep();
+    if (m_undoSteps.isEmpty()) {
+        return QVector<UndoAction>();
+    }
+    Step step = m_undoSteps.takeLast();
+    m_redoSteps.append(step);
+    return decodeStep(step);
+}
+
+QVector<UndoAction> UndoHistory::takeRedoStep()
+{
+    if (m_redoSteps.isEmpty()) {
+        return QVector<UndoAction>();
+    }
+    Step step = m_redoSteps.takeLast();
+    m_undoSteps.append(step);
+    return decodeStep(step);
+}
+
+void UndoHistory::clear()
+{
+    m_undoSteps.clear();
+    m_redoSteps.clear();
+    m_openStep.clear();
+    m_stepDepth = 0;
+    m_entities.clear();
+    m_entityIndex.clear();
+    m_stepBytes = 0;
+}
+
+qint64 UndoHistory::memoryBytes() const
+{
+    return m_stepBytes + stepBytes(m_openStep)
+           + static_cast<qint64>(m_entities.capacity()) * sizeof(Entity*)
+           + static_cast<qint64>(m_entityIndex.size()) * (sizeof(Entity*) + sizeof(quint32) + sizeof(void*));
+}
+
+void UndoHistory::setMemoryLimitBytes(qint64 bytes)
+{
+    m_memoryLimitBytes = bytes;
+    enforceMemoryLimit();
+}
+
+UndoHistory::Command UndoHistory::encode(const UndoAction &action)
+{
+    auto it = m_entityIndex.constFind(action.entity);
+    quint32 entityIndex;
+    if (it != m_entityIndex.constEnd()) {
+        entityIndex = it.value();
+    } else {
+        entityIndex = static_cast<quint32>(m_entities.size());
+        m_entities.append(action.entity);
+        m_entityIndex.insert(action.entity, entityIndex);
+    }
+
+    Command command;
+    command.placementId = action.placementId;
+    command.oldX = static_cast<float>(action.oldPos.x());
+    command.oldY = static_cast<float>(action.oldPos.y());
+    if (action.type == UndoAction::REMOVE) {
+        command.sequence = action.sequence;
+        command.newY = 0;
+    } else {
+        command.newX = static_cast<float>(action.newPos.x());
+        command.newY = static_cast<float>(action.newPos.y());
+    }
+    command.tileIndex = action.tileIndex;
+    command.entityIndex = entityIndex;
+    command.type = static_cast<quint32>(action.type);
+    return command;
+}
+
+UndoAction UndoHistory::decode(const Command &command) const
+{
+    UndoAction action;
+    action.type = static_cast<UndoAction::Type>(command.type);
+    action.entity = m_entities.value(command.entityIndex, nullptr);
+    action.tileIndex = command.tileIndex;
+    action.oldPos = QPointF(command.oldX, command.oldY);
+    action.placementId = command.placementId;
+    if (action.type == UndoAction::REMOVE) {
+        action.newPos = QPointF();
+        action.sequence = command.sequence;
+    } else {
+        action.newPos = QPointF(command.newX, command.newY);
+        action.sequence = PlacementStore::NextSequence;
+    }
+    return action;
+}
+
+QVector<UndoAction> UndoHistory::decodeStep(const Step &step) const
+{
+    QVector<UndoAction> actions;
+    actions.reserve(step.size());
+    for (const Command &command : step) {
+        actions.append(decode(command));
+    }
+    return actions;
+}
+
+qint64 UndoHistory::stepBytes(const Step &step)
+{
+    return sizeof(Step) + sizeof(void*) + static_cast<qint64>(step.capacity()) * sizeof(Command);
+}
+
+void UndoHistory::closeOpenStep()
+{
+    if (m_openStep.isEmpty()) {
+        return;
+    }
+    Step step;
+    step.swap(m_openStep);
+    pushUndoStep(step);
+}
+
+void UndoHistory::pushUndoStep(Step step)
+{
+    step.squeeze();
+    m_stepBytes += stepBytes(step);
+    m_undoSteps.append(step);
+    enforceMemoryLimit();
+}
+
+void UndoHistory::clearRedo()
+{
+    for (const Step &step : m_redoSteps) {
+        m_stepBytes -= stepBytes(step);
+    }
+    m_redoSteps.clear();
+}
+
+void UndoHistory::enforceMemoryLimit()
+{
+    // O passo mais recente fica sempre, mesmo que sozinho passe do limite
+    while (memoryBytes() > m_memoryLimitBytes && m_undoSteps.size() > 1) {
+        m_stepBytes -= stepBytes(m_undoSteps.first());
+        m_undoSteps.removeFirst();
+        ++m_droppedSteps;
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QPointF>
+
+class Entity;
+
+// Uma operação sobre uma colocação, na forma usada para gravar e aplicar
+struct UndoAction
+{
+    enum Type { ADD, REMOVE, MOVE };
+    Type type;
+    Entity *entity;
+    int tileIndex;
+    QPointF oldPos;
+    QPointF newPos;
+    quint64 placementId;
+    // REMOVE: ordem de empilhamento da colocação removida, devolvida no undo. Nas outras
+    // ações vem como PlacementStore::NextSequence
+    quint32 sequence;
+};
+
+// Histórico de undo/redo em passos compostos e compactos.
+//
+// Um passo agrupa tudo o que for gravado entre beginStep() e endStep() (um traço do pincel,
+// um arraste da borracha, mover ou apagar uma seleção); fora de um grupo, cada ação vira um
+// passo próprio. As ações ficam em registros de 32 bytes, com a entidade internada em uma
+// tabela e as posições em float. Quando memoryBytes() passa de memoryLimitBytes(), os passos
+// mais antigos são descartados.
+class UndoHistory
+{
+public:
+    static constexpr qint64 DefaultMemoryLimitBytes = 16 * 1024 * 1024;
+
+    UndoHistory();
+
+    // Podem ser aninhados; o passo fecha no endStep() mais externo
+    void beginStep();
+    void endStep();
+    bool isRecordingStep() const { return m_stepDepth > 0; }
+
+    void record(const UndoAction &action);
+
+    bool canUndo() const;
+    bool canRedo() const;
+    // Ações do passo na ordem em que foram gravadas; o passo passa para a outra pilha
+    QVector<UndoAction> takeUndoStep();
+    QVector<UndoAction> takeRedoStep();
+
+    void clear();
+
+    int undoCount() const { return m_undoSteps.size(); }
+    int redoCount() const { return m_redoSteps.size(); }
+    int droppedStepCount() const { return m_droppedSteps; }
+
+    qint64 memoryBytes() const;
+    qint64 memoryLimitBytes() const { return m_memoryLimitBytes; }
+    void setMemoryLimitBytes(qint64 bytes);
+
+private:
+    struct Command
+    {
+        quint64 placementId;
+        float oldX;
+        float oldY;
+        // REMOVE não usa a posição nova: o slot guarda a sequence
+        union {
+            float newX;
+            quint32 sequence;
+        };
+        float newY;
+        qint32 tileIndex;
+        quint32 entityIndex : 30;
+        quint32 type : 2;
+    };
+    typedef QVector<Command> Step;
+
+    Command encode(const UndoAction &action);
+    UndoAction decode(const Command &command) const;
+    QVector<UndoAction> decodeStep(const Step &step) const;
+    static qint64 stepBytes(const Step &step);
+
+    void closeOpenStep();
+    void pushUndoStep(Step step);
+    void clearRedo();
+    void enforceMemoryLimit();
+
+    QList<Step> m_undoSteps;
+    QList<Step> m_redoSteps;
+    Step m_openStep;
+    int m_stepDepth;
+
+    // Entidades internadas: cada registro guarda só o índice
+    QVector<Entity*> m_entities;
+    QHash<Entity*, quint32> m_entityIndex;
+
+    qint64 m_stepBytes;
+    qint64 m_memoryLimitBytes;
+    int m_droppedSteps;
+};
+
+#endif // UNDOHISTORY_H
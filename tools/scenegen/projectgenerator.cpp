@@ -0,0 +1,292 @@
+#include "projectgenerator.h"
+#include "binaryscenefile.h"
+#include "sceneserializer.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QSaveFile>
+#include <QtMath>
+
+namespace {
+
+const int TileSizes[] = { 32, 64, 128 };
+// Espaço entre os sprites do atlas, como no utree-blocks-basic.xml
+const int AtlasPadding = 2;
+
+bool writeFile(const QString &path, const QByteArray &contents)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar:" << path;
+        return false;
+    }
+    file.write(contents);
+    return file.commit();
+}
+
+QByteArray typeAttribute(ProjectGenerator::EntityKind kind)
+{
+    switch (kind) {
+    case ProjectGenerator::EntityKind::Vertical:
+        return "vertical";
+    case ProjectGenerator::EntityKind::Layerable:
+        return "layerable";
+    default:
+        return "0";
+    }
+}
+
+QByteArray entityXml(ProjectGenerator::EntityKind kind, const QString &imageName, int columns, int rows,
+                     int collisionSize)
+{
+    QByteArray xml = "<?xml version=\"1.0\" ?>\n"
+                     "<Ethanon>\n"
+                     "    <Entity shape=\"1\" sensor=\"0\" bullet=\"0\" fixedRotation=\"0\" friction=\"1\" density=\"1\" "
+                     "restitution=\"0\" gravityScale=\"1\" applyLight=\"0\" castShadow=\"0\" type=\"" + typeAttribute(kind)
+                     + "\" static=\"1\" blendMode=\"0\">\n";
+    if (kind != ProjectGenerator::EntityKind::Invisible) {
+        xml += "        <EmissiveColor r=\"1\" g=\"1\" b=\"1\" a=\"0\" />\n";
+        if (kind != ProjectGenerator::EntityKind::TextureAtlas) {
+            xml += "        <SpriteCut x=\"" + QByteArray::number(columns) + "\" y=\"" + QByteArray::number(rows) + "\" />\n";
+        }
+        xml += "        <Sprite>" + imageName.toUtf8() + "</Sprite>\n";
+    }
+    xml += "        <Particles />\n"
+           "        <Collision>\n"
+           "            <Position x=\"0\" y=\"0\" z=\"0\" />\n"
+           "            <Size x=\"" + QByteArray::number(collisionSize) + "\" y=\"" + QByteArray::number(collisionSize)
+           + "\" z=\"1\" />\n"
+           "        </Collision>\n"
+           "    </Entity>\n"
+           "</Ethanon>\n";
+    return xml;
+}
+
+}
+
+ProjectGenerator::ProjectGenerator(quint32 seed)
+    : m_random(seed)
+{
+}
+
+ProjectGenerator::EntityKind ProjectGenerator::pickKind()
+{
+    // 35% SpriteCut, 35% atlas, 10% de cada um dos outros
+    const int roll = static_cast<int>(m_random.bounded(100));
+    if (roll < 35) {
+        return EntityKind::SpriteCut;
+    }
+    if (roll < 70) {
+        return EntityKind::TextureAtlas;
+    }
+    if (roll < 80) {
+        return EntityKind::Invisible;
+    }
+    return roll < 90 ? EntityKind::Vertical : EntityKind::Layerable;
+}
+
+bool ProjectGenerator::writeSheet(const QString &entitiesDir, const Sheet &sheet, bool atlas)
+{
+    const int stride = atlas ? sheet.tileSize + 2 * AtlasPadding : sheet.tileSize;
+    QImage image(sheet.columns * stride, sheet.rows * stride, QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+
+    QByteArray atlasXml;
+    if (atlas) {
+        atlasXml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<TextureAtlas imagePath=\"" + sheet.imageName.toUtf8() + "\" width=\""
+                   + QByteArray::number(image.width()) + "\" height=\"" + QByteArray::number(image.height()) + "\">\n";
+    }
+
+    // Um tile de cor própria por célula, com borda, para dar para ver o corte no editor
+    QPainter painter(&image);
+    const QString baseName = QFileInfo(sheet.imageName).completeBaseName();
+    for (int row = 0; row < sheet.rows; ++row) {
+        for (int column = 0; column < sheet.columns; ++column) {
+            const int index = row * sheet.columns + column;
+            const int x = column * stride + (atlas ? AtlasPadding : 0);
+            const int y = row * stride + (atlas ? AtlasPadding : 0);
+            const QColor color = QColor::fromHsv((index * 37) % 360, 160 + (index * 13) % 80, 200);
+            painter.fillRect(x, y, sheet.tileSize, sheet.tileSize, color.darker(140));
+            painter.fillRect(x + 2, y + 2, sheet.tileSize - 4, sheet.tileSize - 4, color);
+
+            if (atlas) {
+                const QByteArray size = QByteArray::number(sheet.tileSize);
+                atlasXml += "    <sprite n=\"" + baseName.toUtf8() + "-" + QByteArray::number(index + 1) + ".png\" x=\""
+                            + QByteArray::number(x) + "\" y=\"" + QByteArray::number(y) + "\" w=\"" + size + "\" h=\""
+                            + size + "\" oX=\"0\" oY=\"0\" oW=\"" + size + "\" oH=\"" + size + "\"/>\n";
+            }
+        }
+    }
+    painter.end();
+
+    const QDir dir(entitiesDir);
+    if (!image.save(dir.filePath(sheet.imageName), "PNG")) {
+        qWarning() << "Não foi possível gravar a imagem:" << dir.filePath(sheet.imageName);
+        return false;
+    }
+    if (atlas) {
+        atlasXml += "</TextureAtlas>\n";
+        return writeFile(dir.filePath(baseName + ".xml"), atlasXml);
+    }
+    return true;
+}
+
+bool ProjectGenerator::generateProject(const QString &projectDir, int entityCount, int sheetCount)
+{
+    const QString entitiesDir = QDir(projectDir).filePath("entities");
+    if (!QDir().mkpath(entitiesDir)) {
+        qWarning() << "Não foi possível criar o diretório:" << entitiesDir;
+        return false;
+    }
+    sheetCount = qMax(1, sheetCount);
+
+    // Spritesheets compartilhados: os cortados por SpriteCut não podem ter .xml com o mesmo nome,
+    // senão o loader usa o atlas
+    QVector<Sheet> gridSheets;
+    QVector<Sheet> atlasSheets;
+    for (int i = 0; i < sheetCount; ++i) {
+        Sheet grid = { QString("grid_%1.png").arg(i, 3, 10, QChar('0')),
+                       1 + static_cast<int>(m_random.bounded(8)), 1 + static_cast<int>(m_random.bounded(4)),
+                       TileSizes[m_random.bounded(3)] };
+        Sheet atlas = { QString("atlas_%1.png").arg(i, 3, 10, QChar('0')),
+                        1 + static_cast<int>(m_random.bounded(8)), 1 + static_cast<int>(m_random.bounded(4)),
+                        TileSizes[m_random.bounded(3)] };
+        if (!writeSheet(entitiesDir, grid, false) || !writeSheet(entitiesDir, atlas, true)) {
+            return false;
+        }
+        gridSheets.append(grid);
+        atlasSheets.append(atlas);
+    }
+
+    m_entities.clear();
+    m_entities.reserve(entityCount);
+    for (int i = 0; i < entityCount; ++i) {
+        const EntityKind kind = pickKind();
+        GeneratedEntity entity = { QString(), kind, 1, CellSize };
+        QByteArray xml;
+
+        if (kind == EntityKind::Invisible) {
+            entity.name = QString("invisible_%1").arg(i, 5, 10, QChar('0'));
+            entity.tileSize = TileSizes[m_random.bounded(3)];
+            xml = entityXml(kind, QString(), 1, 1, entity.tileSize);
+        } else {
+            const bool atlas = kind == EntityKind::TextureAtlas;
+            const Sheet &sheet = atlas ? atlasSheets.at(static_cast<int>(m_random.bounded(sheetCount)))
+                                       : gridSheets.at(static_cast<int>(m_random.bounded(sheetCount)));
+            const char *prefix = atlas ? "atlas" : kind == EntityKind::Vertical ? "vertical"
+                                                 : kind == EntityKind::Layerable ? "layerable" : "cut";
+            entity.name = QString("%1_%2").arg(prefix).arg(i, 5, 10, QChar('0'));
+            entity.spriteCount = sheet.columns * sheet.rows;
+            entity.tileSize = sheet.tileSize;
+            xml = entityXml(kind, sheet.imageName, sheet.columns, sheet.rows, sheet.tileSize);
+        }
+
+        if (!writeFile(QDir(entitiesDir).filePath(entity.name + ".ent"), xml)) {
+            return false;
+        }
+        m_entities.append(entity);
+    }
+    return true;
+}
+
+QPoint ProjectGenerator::scenePosition(int index, int placementCount, Distribution distribution,
+                                       const QVector<QPoint> &clusterCenters, int worldSize)
+{
+    switch (distribution) {
+    case Distribution::Grid: {
+        const int columns = qCeil(qSqrt(placementCount));
+        return QPoint((index % columns) * CellSize + CellSize / 2, (index / columns) * CellSize + CellSize / 2);
+    }
+    case Distribution::Clustered: {
+        // Soma de uniformes: aproximadamente normal em volta do centro, sem depender de <random>
+        const QPoint &center = clusterCenters.at(static_cast<int>(m_random.bounded(clusterCenters.size())));
+        const int spread = CellSize * 8;
+        int dx = 0;
+        int dy = 0;
+        for (int i = 0; i < 4; ++i) {
+            dx += static_cast<int>(m_random.bounded(2 * spread + 1)) - spread;
+            dy += static_cast<int>(m_random.bounded(2 * spread + 1)) - spread;
+        }
+        return center + QPoint(dx / 2, dy / 2);
+    }
+    case Distribution::Random:
+        break;
+    }
+    return QPoint(static_cast<int>(m_random.bounded(worldSize)), static_cast<int>(m_random.bounded(worldSize)));
+}
+
+bool ProjectGenerator::generateScene(const QString &path, int placementCount, Distribution distribution)
+{
+    if (m_entities.isEmpty()) {
+        qWarning() << "Nenhuma entidade gerada para a cena";
+        return false;
+    }
+
+    // Mundo com cerca de 25% de ocupação para as distribuições esparsas
+    const int worldSize = qMax(CellSize, qCeil(qSqrt(placementCount)) * CellSize * 2);
+    QVector<QPoint> clusterCenters;
+    if (distribution == Distribution::Clustered) {
+        const int clusterCount = qMax(1, placementCount / 1000);
+        for (int i = 0; i < clusterCount; ++i) {
+            clusterCenters.append(QPoint(static_cast<int>(m_random.bounded(worldSize)),
+                                         static_cast<int>(m_random.bounded(worldSize))));
+        }
+    }
+
+    SceneSerializer serializer;
+    serializer.reserve(placementCount);
+    QVector<qint64> nameIndexes(m_entities.size(), -1);
+    for (int i = 0; i < placementCount; ++i) {
+        const int entityIndex = static_cast<int>(m_random.bounded(m_entities.size()));
+        const GeneratedEntity &entity = m_entities.at(entityIndex);
+        if (nameIndexes.at(entityIndex) < 0) {
+            nameIndexes[entityIndex] = serializer.internName(entity.name);
+        }
+        const int spriteFrame = static_cast<int>(m_random.bounded(entity.spriteCount));
+        const QPoint pos = scenePosition(i, placementCount, distribution, clusterCenters, worldSize);
+        // Ids a partir de 1, únicos como os de um save do editor
+        serializer.addRecord(static_cast<quint32>(nameIndexes.at(entityIndex)), spriteFrame, pos.x(), pos.y(),
+                             static_cast<quint64>(i) + 1);
+    }
+
+    if (path.endsWith(".escb")) {
+        return BinarySceneFile::write(path, serializer);
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Não foi possível gravar a cena:" << path;
+        return false;
+    }
+    return serializer.writeEsc(&file) && file.commit();
+}
+
+bool ProjectGenerator::parseDistribution(const QString &name, Distribution *distribution)
+{
+    if (name == "grid") {
+        *distribution = Distribution::Grid;
+    } else if (name == "clustered") {
+        *distribution = Distribution::Clustered;
+    } else if (name == "random") {
+        *distribution = Distribution::Random;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString ProjectGenerator::distributionName(Distribution distribution)
+{
+    switch (distribution) {
+    case Distribution::Grid:
+        return "grid";
+    case Distribution::Clustered:
+        return "clustered";
+    case Distribution::Random:
+        break;
+    }
+    return "random";
+}
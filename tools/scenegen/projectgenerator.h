@@ -0,0 +1,71 @@
+#ifndef PROJECTGENERATOR_H
+#define PROJECTGENERATOR_H
+
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Gera um projeto sintético (entities/ com .ent, PNGs e atlas .xml) e cenas .esc/.escb sobre ele.
+//
+// Tudo sai de um QRandomGenerator com a semente dada: a mesma semente e as mesmas opções
+// produzem os mesmos arquivos, byte a byte, para os benchmarks compararem revisões.
+class ProjectGenerator
+{
+public:
+    enum class Distribution {
+        Grid,       // Grade densa, sem buracos
+        Clustered,  // Aglomerados em volta de centros sorteados
+        Random      // Uniforme no mundo
+    };
+
+    enum class EntityKind {
+        SpriteCut,
+        TextureAtlas,
+        Invisible,  // Só colisão, sem <Sprite>
+        Vertical,
+        Layerable
+    };
+
+    struct GeneratedEntity
+    {
+        QString name;
+        EntityKind kind;
+        int spriteCount;
+        int tileSize;
+    };
+
+    static constexpr int DefaultSheetCount = 16;
+    static constexpr int CellSize = 64;
+
+    explicit ProjectGenerator(quint32 seed);
+
+    // entities/ dentro de projectDir; sheetCount PNGs de cada tipo são compartilhados pelas entidades
+    bool generateProject(const QString &projectDir, int entityCount, int sheetCount = DefaultSheetCount);
+    // .esc ou .escb pela extensão; usa as entidades do último generateProject()
+    bool generateScene(const QString &path, int placementCount, Distribution distribution);
+
+    const QVector<GeneratedEntity> &entities() const { return m_entities; }
+
+    static bool parseDistribution(const QString &name, Distribution *distribution);
+    static QString distributionName(Distribution distribution);
+
+private:
+    struct Sheet
+    {
+        QString imageName;
+        int columns;
+        int rows;
+        int tileSize;
+    };
+
+    EntityKind pickKind();
+    bool writeSheet(const QString &entitiesDir, const Sheet &sheet, bool atlas);
+    QPoint scenePosition(int index, int placementCount, Distribution distribution,
+                         const QVector<QPoint> &clusterCenters, int worldSize);
+
+    QRandomGenerator m_random;
+    QVector<GeneratedEntity> m_entities;
+};
+
+#endif // PROJECTGENERATOR_H
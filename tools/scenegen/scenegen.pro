@@ -0,0 +1,15 @@
+QT = core gui concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = scenegen
+
+include(../../core/core.pri)
+
+SOURCES += \
+    main.cpp \
+    projectgenerator.cpp
+
+HEADERS += \
+    projectgenerator.h
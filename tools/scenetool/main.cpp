@@ -0,0 +1,140 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include "binaryscenefile.h"
+#include "entity.h"
+#include "entitymanager.h"
+#include "scenemodel.h"
+#include "sceneserializer.h"
+
+// Ferramenta de linha de comando sobre o core da cena, sem QtWidgets:
+//   scenetool convert <origem> <destino>        .esc <-> .escb, pela extensão da origem
+//   scenetool info <cena> [--project <dir>]     registros da cena; com o projeto, importa como o editor
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+int convertScene(const QString &source, const QString &target)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool toBinary = !source.endsWith(".escb");
+    const bool ok = toBinary ? BinarySceneFile::convertEscToEscb(source, target)
+                             : BinarySceneFile::convertEscbToEsc(source, target);
+    if (!ok) {
+        err() << "Não foi possível converter " << source << " para " << target << Qt::endl;
+        return 1;
+    }
+    out() << source << " -> " << target << " em " << timer.elapsed() << " ms" << Qt::endl;
+    return 0;
+}
+
+// Sem projeto: só o conteúdo do arquivo, sem resolver entidades
+int sceneFileInfo(const QString &path)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SceneSerializer serializer;
+    if (path.endsWith(".escb")) {
+        BinarySceneFile binary;
+        if (!binary.open(path)) {
+            err() << "Não foi possível abrir a cena binária: " << path << Qt::endl;
+            return 1;
+        }
+        out() << "Chunks: " << binary.chunkCount() << Qt::endl;
+        binary.toSerializer(serializer);
+    } else {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly) || !serializer.readEsc(&file)) {
+            err() << "Não foi possível ler a cena: " << path << Qt::endl;
+            return 1;
+        }
+    }
+
+    out() << "Registros: " << serializer.recordCount() << Qt::endl;
+    out() << "Entidades distintas: " << serializer.nameCount() << Qt::endl;
+    out() << "Lida em " << timer.elapsed() << " ms" << Qt::endl;
+    return 0;
+}
+
+int projectSceneInfo(const QString &path, const QString &projectPath)
+{
+    EntityManager entityManager;
+    QElapsedTimer timer;
+    timer.start();
+    entityManager.loadEntitiesFromDirectory(projectPath + "/entities");
+    out() << "Entidades do projeto: " << entityManager.getAllEntities().size()
+          << " em " << timer.elapsed() << " ms" << Qt::endl;
+
+    SceneModel model(&entityManager);
+    model.setProjectPath(projectPath);
+    // Não toca no journal nem na sessão do editor
+    model.setJournalEnabled(false);
+
+    SceneModel::FileStats stats;
+    if (!model.importScene(path, &stats)) {
+        err() << model.errorString() << Qt::endl;
+        return 1;
+    }
+    if (!model.errorString().isEmpty()) {
+        err() << model.errorString() << Qt::endl;
+    }
+
+    const PlacementStore &placements = model.placements();
+    out() << "Colocações: " << placements.count() << Qt::endl;
+    out() << "Não encontradas: " << stats.missingCount << Qt::endl;
+    const QRectF bounds = placements.boundingRect();
+    out() << "Limites: " << bounds.x() << "," << bounds.y() << " "
+          << bounds.width() << "x" << bounds.height() << Qt::endl;
+    const int entitiesPerSecond = stats.elapsedMs > 0 ? qRound(stats.entityCount * 1000.0 / stats.elapsedMs)
+                                                      : stats.entityCount;
+    out() << "Importada em " << stats.elapsedMs << " ms (" << entitiesPerSecond << " entidades/s)" << Qt::endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("scenetool");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Converte e inspeciona cenas (.esc e .escb) sem abrir o editor.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("comando", "convert <origem> <destino> | info <cena>");
+    QCommandLineOption projectOption("project", "Diretório do projeto (com entities/) para importar a cena.", "dir");
+    parser.addOption(projectOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QString command = args.value(0);
+    if (command == "convert" && args.size() == 3) {
+        return convertScene(args.at(1), args.at(2));
+    }
+    if (command == "info" && args.size() == 2) {
+        if (!QFileInfo::exists(args.at(1))) {
+            err() << "Arquivo não encontrado: " << args.at(1) << Qt::endl;
+            return 1;
+        }
+        return parser.isSet(projectOption) ? projectSceneInfo(args.at(1), parser.value(projectOption))
+                                           : sceneFileInfo(args.at(1));
+    }
+
+    parser.showHelp(1);
+}
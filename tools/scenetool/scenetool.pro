@@ -0,0 +1,11 @@
+QT = core gui concurrent
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = scenetool
+
+include(../../core/core.pri)
+
+SOURCES += \
+    main.cpp